@@ -1,4 +1,4 @@
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -9,13 +9,62 @@ CONFIG += c++17
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    analysisworker.cpp \
+    circlefit.cpp \
+    circlingindex.cpp \
+    distancemodel.cpp \
+    flightgeometry.cpp \
+    flightmetrics.cpp \
+    flighttrack.cpp \
+    geodesy.cpp \
     igcanalyzer.cpp \
+    igcparser.cpp \
+    igcparser_avx2.cpp \
+    igcparser_sse2.cpp \
+    kernels.cpp \
+    kernels_avx2.cpp \
+    kernels_avx512.cpp \
+    kernels_sse2.cpp \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    metricregistry.cpp \
+    olcoptimizer.cpp \
+    phaseindex.cpp \
+    scoringengine.cpp \
+    segmentindex.cpp \
+    thermaldetector.cpp \
+    trackprojection.cpp \
+    trackresampler.cpp \
+    tracksimplifier.cpp \
+    variofilter.cpp \
+    windestimator.cpp
 
 HEADERS += \
+    analysisworker.h \
+    circlefit.h \
+    circlingindex.h \
+    distancemodel.h \
+    flightgeometry.h \
+    flightmetrics.h \
+    flighttrack.h \
+    geodesy.h \
     igcanalyzer.h \
-    mainwindow.h
+    igcparser.h \
+    igcparser_p.h \
+    kernels.h \
+    kernels_p.h \
+    mainwindow.h \
+    metricregistry.h \
+    olcoptimizer.h \
+    phaseindex.h \
+    scoringengine.h \
+    segmentindex.h \
+    thermaldetector.h \
+    trackprojection.h \
+    trackresampler.h \
+    tracksimplifier.h \
+    variofilter.h \
+    windestimator.h
 
 FORMS += \
     mainwindow.ui
@@ -0,0 +1,99 @@
+// Background loading and analysis with cancellation
+#include "analysisworker.h"
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+
+AnalysisWorker::AnalysisWorker(QObject *parent) : QObject(parent) {
+    pool.setMaxThreadCount(2); // a stopped job may still be unwinding when the next starts
+}
+
+AnalysisWorker::~AnalysisWorker() {
+    stop();
+    pool.waitForDone();
+}
+
+void AnalysisWorker::load(const QString &fileName) {
+    start(Load, new IGCAnalyzer, 0, [fileName](IGCAnalyzer &analyzer, const Stage &stage) {
+        if (!stage(0, "Reading flight") || !analyzer.loadIGCFile(fileName)) return false;
+        if (!stage(40, "Computing flight statistics")) return false;
+        analyzer.prepare(IGCAnalyzer::Summary);
+        if (!stage(70, "Finding flight phases")) return false;
+        analyzer.prepare(IGCAnalyzer::Hull);
+        analyzer.prepare(IGCAnalyzer::Phases);
+        return stage(100, "Flight loaded");
+    });
+}
+
+void AnalysisWorker::analyzeThermals(const IGCAnalyzer &current, const ThermalParameters &parameters) {
+    IGCAnalyzer *analyzer = current.clone();
+    analyzer->setThermalParameters(parameters);
+    start(Thermals, analyzer, 50, [](IGCAnalyzer &analyzer, const Stage &stage) {
+        if (!stage(0, "Segmenting climbs")) return false;
+        analyzer.prepare(IGCAnalyzer::Climbs);
+        if (!stage(30, "Detecting thermals")) return false;
+        analyzer.prepare(IGCAnalyzer::Thermals);
+        if (!stage(50, "Optimizing cross-country distance")) return false;
+        analyzer.prepare(IGCAnalyzer::Scores);
+        return stage(100, "Analysis complete");
+    });
+}
+
+void AnalysisWorker::score(const IGCAnalyzer &current) {
+    start(Scores, current.clone(), 0, [](IGCAnalyzer &analyzer, const Stage &stage) {
+        if (!stage(0, "Optimizing cross-country distance")) return false;
+        analyzer.prepare(IGCAnalyzer::Scores);
+        return stage(100, "XC analysis complete");
+    });
+}
+
+void AnalysisWorker::cancel() {
+    if (!running) return;
+    const Job job = running->job;
+    stop();
+    emit cancelled(job);
+}
+
+void AnalysisWorker::stop() {
+    if (!running) return;
+    running->cancelled.storeRelaxed(1);
+    running->analyzer->getScoringEngine()->cancel(); // holds even if scoring has not started yet
+    running.reset(); // whatever it still delivers is dropped
+}
+
+void AnalysisWorker::start(Job job, IGCAnalyzer *analyzer, int scoringFrom, const Work &work) {
+    stop();
+
+    auto task = std::make_shared<Task>();
+    task->job = job;
+    // Deleted on the thread that created it, wherever the last reference goes
+    task->analyzer = std::shared_ptr<IGCAnalyzer>(analyzer, [](IGCAnalyzer *analyzer) { analyzer->deleteLater(); });
+    running = task;
+
+    // Stages and scoring bounds arrive from the pool; only the running job's
+    // reach the progress signal
+    const std::weak_ptr<Task> weakTask = task;
+    auto report = [this, weakTask](int percentage, const QString &stage) {
+        if (running && running == weakTask.lock()) emit progress(percentage, stage);
+    };
+    connect(analyzer->getScoringEngine(), &ScoringEngine::boundsImproved, this,
+            [report, scoringFrom](ScoringEngine::Discipline discipline, double best, double upperBound) {
+                // An equal share per discipline, filled as the best closes on its bound
+                const double done = discipline + (upperBound > 0.0 ? std::min(best / upperBound, 1.0) : 0.0);
+                report(scoringFrom + int((100 - scoringFrom) * done / 3.0), "Optimizing cross-country distance");
+            });
+    const Stage stage = [this, report, weakTask](int percentage, const QString &name) {
+        const std::shared_ptr<Task> current = weakTask.lock();
+        if (!current || current->cancelled.loadRelaxed()) return false;
+        QMetaObject::invokeMethod(this, [report, percentage, name] { report(percentage, name); }, Qt::QueuedConnection);
+        return true;
+    };
+
+    QtConcurrent::run(&pool, [task, work, stage] {
+        return work(*task->analyzer, stage) && !task->cancelled.loadRelaxed();
+    }).then(this, [this, task](bool complete) {
+        if (task != running) return; // stopped or superseded
+        running.reset();
+        if (complete) emit finished(task->job, task->analyzer);
+        else emit failed(task->job);
+    });
+}
@@ -0,0 +1,69 @@
+#ifndef ANALYSISWORKER_H
+#define ANALYSISWORKER_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QThreadPool>
+#include <functional>
+#include <memory>
+
+#include "igcanalyzer.h"
+
+// Loads and analyzes flights off the GUI thread.
+//
+// A job works on an analyzer nobody else can see: a fresh one for a load,
+// a clone of the caller's otherwise, so the metric registry never crosses
+// threads. The analyzer is created on the calling thread, filled on the
+// worker's pool and handed back through finished(); the worker never
+// touches it again, so the receiver can keep it as an immutable snapshot.
+// One job runs at a time. Starting another or calling cancel() stops the
+// current one at its next stage (scoring at once) and drops its results.
+// All signals are emitted on the thread that owns the worker.
+class AnalysisWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Job {
+        Load,       // parse, statistics, hull and phases
+        Thermals,   // thermal detection, then the scores
+        Scores
+    };
+    Q_ENUM(Job)
+
+    explicit AnalysisWorker(QObject *parent = nullptr);
+    ~AnalysisWorker() override; // cancels and waits for the pool
+
+    void load(const QString &fileName);
+    void analyzeThermals(const IGCAnalyzer &current, const ThermalParameters &parameters);
+    void score(const IGCAnalyzer &current);
+    void cancel();
+
+    bool isBusy() const { return running != nullptr; }
+
+signals:
+    void progress(int percentage, const QString &stage);
+    void finished(AnalysisWorker::Job job, std::shared_ptr<const IGCAnalyzer> snapshot);
+    void failed(AnalysisWorker::Job job);       // the file could not be loaded
+    void cancelled(AnalysisWorker::Job job);
+
+private:
+    struct Task {
+        Job job;
+        std::shared_ptr<IGCAnalyzer> analyzer;
+        QAtomicInt cancelled;
+    };
+
+    // Reports a stage; false once the job has been cancelled
+    typedef std::function<bool(int percentage, const QString &stage)> Stage;
+    typedef std::function<bool(IGCAnalyzer &analyzer, const Stage &stage)> Work;
+
+    // Scoring, if the work reaches it, fills progress from scoringFrom to 100
+    void start(Job job, IGCAnalyzer *analyzer, int scoringFrom, const Work &work);
+    void stop();                // cancels the running job without a signal
+
+    QThreadPool pool;
+    std::shared_ptr<Task> running;
+};
+
+#endif // ANALYSISWORKER_H
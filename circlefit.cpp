@@ -0,0 +1,115 @@
+// Incremental algebraic circle fits
+#include "circlefit.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double Binomial[5][5] = {
+    {1, 0, 0, 0, 0},
+    {1, 1, 0, 0, 0},
+    {1, 2, 1, 0, 0},
+    {1, 3, 3, 1, 0},
+    {1, 4, 6, 4, 1}
+};
+
+}
+
+void CircleFit::add(double x, double y) {
+    if (count == 0) {
+        originX = x;
+        originY = y;
+    }
+    count++;
+    accumulate(x, y, 1.0);
+}
+
+void CircleFit::remove(double x, double y) {
+    if (--count == 0) {
+        clear(); // start the next window exact
+        return;
+    }
+    accumulate(x, y, -1.0);
+}
+
+void CircleFit::accumulate(double x, double y, double weight) {
+    const double dx = x - originX;
+    const double dy = y - originY;
+    double px = weight;
+    for (int i = 0; i <= 4; i++) {
+        double term = px;
+        for (int j = 0; i + j <= 4; j++) {
+            sums[i][j] += term;
+            term *= dy;
+        }
+        px *= dx;
+    }
+}
+
+double CircleFit::central(int i, int j, double meanX, double meanY) const {
+    // Binomial expansion of the raw sums about the mean
+    double moment = 0.0;
+    for (int a = 0; a <= i; a++) {
+        for (int b = 0; b <= j; b++) {
+            moment += Binomial[i][a] * Binomial[j][b] * std::pow(-meanX, i - a) * std::pow(-meanY, j - b) * sums[a][b];
+        }
+    }
+    return moment / count;
+}
+
+bool CircleFit::solve(Method method, double &centreX, double &centreY, double &radius) const {
+    if (count < 3) return false;
+    const double meanX = sums[1][0] / count;
+    const double meanY = sums[0][1] / count;
+
+    // Moments of the centred points and of z = x^2 + y^2
+    const double mxx = central(2, 0, meanX, meanY);
+    const double myy = central(0, 2, meanX, meanY);
+    const double mxy = central(1, 1, meanX, meanY);
+    const double mxz = central(3, 0, meanX, meanY) + central(1, 2, meanX, meanY);
+    const double myz = central(2, 1, meanX, meanY) + central(0, 3, meanX, meanY);
+    const double mz = mxx + myy;
+    const double covXY = mxx * myy - mxy * mxy;
+
+    // Kasa solves the 2x2 normal equations directly; Taubin shifts their
+    // diagonal by the root of its characteristic polynomial (Newton from 0)
+    double eta = 0.0;
+    if (method == Taubin) {
+        const double mzz = central(4, 0, meanX, meanY) + 2.0 * central(2, 2, meanX, meanY) + central(0, 4, meanX, meanY);
+        const double varZ = mzz - mz * mz;
+        const double a3 = 4.0 * mz;
+        const double a2 = -3.0 * mz * mz - mzz;
+        const double a1 = varZ * mz + 4.0 * covXY * mz - mxz * mxz - myz * myz;
+        const double a0 = mxz * (mxz * myy - myz * mxy) + myz * (myz * mxx - mxz * mxy) - varZ * covXY;
+        double value = a0;
+        for (int iteration = 0; iteration < 100; iteration++) {
+            const double slope = a1 + eta * (2.0 * a2 + 3.0 * a3 * eta);
+            const double next = eta - value / slope;
+            if (next == eta || !std::isfinite(next)) break;
+            const double nextValue = a0 + next * (a1 + next * (a2 + next * a3));
+            if (std::abs(nextValue) >= std::abs(value)) break;
+            eta = next;
+            value = nextValue;
+        }
+    }
+
+    const double det = eta * eta - eta * mz + covXY;
+    if (!(std::abs(det) > 1e-12 * mz * mz)) return false;
+    const double x = (mxz * (myy - eta) - myz * mxy) / det / 2.0;
+    const double y = (myz * (mxx - eta) - mxz * mxy) / det / 2.0;
+    centreX = originX + meanX + x;
+    centreY = originY + meanY + y;
+    radius = std::sqrt(x * x + y * y + mz);
+    return true;
+}
+
+double CircleFit::meanSquareError(double centreX, double centreY, double radius) const {
+    if (count == 0 || radius <= 0.0) return 0.0;
+    // Mean of (d^2 - r^2)^2 from the moments about the centre, over (2r)^2
+    const double x = centreX - originX;
+    const double y = centreY - originY;
+    const double d4 = central(4, 0, x, y) + 2.0 * central(2, 2, x, y) + central(0, 4, x, y);
+    const double d2 = central(2, 0, x, y) + central(0, 2, x, y);
+    const double r2 = radius * radius;
+    return std::max(0.0, d4 - 2.0 * r2 * d2 + r2 * r2) / (4.0 * r2);
+}
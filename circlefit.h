@@ -0,0 +1,36 @@
+#ifndef CIRCLEFIT_H
+#define CIRCLEFIT_H
+
+// Least-squares circle through a stream of points.
+//
+// Keeps power sums of the coordinates up to the fourth, taken about the
+// first point so they stay small, so adding or removing a point is O(1)
+// and a fit can be read at any time; a sliding window is one remove per
+// add. Kasa is the plain algebraic fit; Taubin normalizes it by the
+// gradient and does not shrink the radius on partial arcs.
+class CircleFit {
+public:
+    enum Method { Kasa, Taubin };
+
+    void add(double x, double y);
+    void remove(double x, double y); // a point added earlier
+    void clear() { *this = CircleFit(); }
+    int size() const { return count; }
+
+    // False with fewer than three points or when they lie on a line
+    bool solve(Method method, double &centreX, double &centreY, double &radius) const;
+
+    // Mean squared distance of the points from a circle, to first order
+    double meanSquareError(double centreX, double centreY, double radius) const;
+
+private:
+    int count = 0;
+    double originX = 0.0;
+    double originY = 0.0;
+    double sums[5][5] = {};     // sums[i][j]: sum of dx^i dy^j, i + j <= 4
+
+    void accumulate(double x, double y, double weight);
+    double central(int i, int j, double meanX, double meanY) const; // mean of (x - mean)^i (y - mean)^j
+};
+
+#endif // CIRCLEFIT_H
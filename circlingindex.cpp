@@ -0,0 +1,96 @@
+// Turn-rate detection of circling
+#include "circlingindex.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double TurnWindow = 10.0;     // s, full width the turn rate is measured over
+const double MinTurnRate = 8.0;     // degrees/s, a turn takes under 45 s
+
+}
+
+CirclingIndex::CirclingIndex(QSpan<const int> times, QSpan<const double> courses, QSpan<const double> groundSpeeds)
+    : time(times.begin(), times.end()) {
+    const qsizetype count = std::min({times.size(), courses.size(), groundSpeeds.size()});
+    if (count < 3) return;
+
+    // Course change into each fix, wrapped to [-180, 180). Only legs on
+    // both sides that were actually flown count; a slow fix adds no turn
+    // rather than breaking the running sum below.
+    std::vector<double> heading(size_t(count), 0.0);
+    for (qsizetype i = 1; i < count; i++) {
+        double change = courses[i] - courses[i-1];
+        change -= 360.0 * std::floor(change / 360.0 + 0.5);
+        const bool flown = groundSpeeds[i] > MinCourseSpeed && groundSpeeds[i-1] > MinCourseSpeed;
+        heading[size_t(i)] = flown ? change : 0.0;
+    }
+    for (size_t i = 1; i < size_t(count); i++) heading[i] += heading[i-1]; // unwrapped
+
+    // Turn direction at each fix from the heading change across the window
+    std::vector<signed char> turning(size_t(count), 0);
+    qsizetype lo = 0;
+    qsizetype hi = 0;
+    for (qsizetype i = 0; i < count; i++) {
+        while (times[lo] < times[i] - TurnWindow * 0.5) lo++;
+        hi = std::max(hi, i);
+        while (hi + 1 < count && times[hi + 1] <= times[i] + TurnWindow * 0.5) hi++;
+        const int span = times[hi] - times[lo];
+        if (span <= 0) continue;
+        const double rate = (heading[size_t(hi)] - heading[size_t(lo)]) / span;
+        turning[size_t(i)] = rate >= MinTurnRate ? 1 : (rate <= -MinTurnRate ? -1 : 0);
+    }
+
+    // Runs of one direction, kept when they complete a turn
+    for (qsizetype first = 0; first < count;) {
+        qsizetype last = first;
+        while (last + 1 < count && turning[size_t(last + 1)] == turning[size_t(first)]) last++;
+
+        const double turned = std::abs(heading[size_t(last)] - heading[size_t(first)]);
+        const int duration = times[last] - times[first];
+        if (turning[size_t(first)] != 0 && turned >= 360.0 && duration > 0) {
+            double speedSum = 0.0;
+            for (qsizetype i = first + 1; i <= last; i++) speedSum += groundSpeeds[i];
+            const double turnRate = qDegreesToRadians(turned) / duration; // rad/s
+
+            CirclingRun run;
+            run.first = int(first);
+            run.last = int(last);
+            run.direction = turning[size_t(first)];
+            run.period = 360.0 * duration / turned;
+            run.radius = speedSum / (last - first) / turnRate;
+            circles.push_back(run);
+        }
+        first = last + 1;
+    }
+}
+
+std::vector<CirclingRun>::const_iterator CirclingIndex::firstOverlap(int first) const {
+    return std::lower_bound(circles.begin(), circles.end(), first,
+                            [](const CirclingRun &run, int fix) { return run.last < fix; });
+}
+
+const CirclingRun* CirclingIndex::runAt(int fix) const {
+    auto run = firstOverlap(fix);
+    return run != circles.end() && run->first <= fix ? &*run : nullptr;
+}
+
+int CirclingIndex::circlingTime(int first, int last) const {
+    int seconds = 0;
+    for (auto run = firstOverlap(first); run != circles.end() && run->first <= last; ++run) {
+        seconds += time[size_t(std::min(last, run->last))] - time[size_t(std::max(first, run->first))];
+    }
+    return seconds;
+}
+
+double CirclingIndex::meanRadius(int first, int last) const {
+    double weighted = 0.0;
+    int seconds = 0;
+    for (auto run = firstOverlap(first); run != circles.end() && run->first <= last; ++run) {
+        const int overlap = time[size_t(std::min(last, run->last))] - time[size_t(std::max(first, run->first))];
+        weighted += run->radius * overlap;
+        seconds += overlap;
+    }
+    return seconds > 0 ? weighted / seconds : 0.0;
+}
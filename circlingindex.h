@@ -0,0 +1,46 @@
+#ifndef CIRCLINGINDEX_H
+#define CIRCLINGINDEX_H
+
+#include <QSpan>
+#include <vector>
+
+// m/s; slower than this a fix's course is GPS noise. Circling detection and
+// the wind fit both gate on it, so they agree on which legs were flown.
+constexpr double MinCourseSpeed = 2.0;
+
+// A stretch of continuous turning in one direction, at least a full turn
+struct CirclingRun {
+    int first = 0;          // fixes [first, last]
+    int last = 0;
+    int direction = 0;      // 1 right (clockwise), -1 left
+    double period = 0.0;    // s per full turn
+    double radius = 0.0;    // m, mean ground speed over the turn rate
+};
+
+// Circling phases of a flight as run-length intervals.
+//
+// The course column is unwrapped into a continuous heading, and the turn
+// rate at each fix is the heading change across a window of seconds around
+// it, so the result does not depend on the logging rate. Fixes turning
+// faster than 8 degrees per second one way form a run; runs that do not
+// complete a full turn (S-turns, corrections) are dropped.
+class CirclingIndex {
+public:
+    CirclingIndex() = default;
+    CirclingIndex(QSpan<const int> times, QSpan<const double> courses, QSpan<const double> groundSpeeds);
+
+    bool isEmpty() const { return circles.empty(); }
+    const std::vector<CirclingRun>& runs() const { return circles; } // ascending, disjoint
+
+    const CirclingRun* runAt(int fix) const; // nullptr when not circling
+    int circlingTime(int first, int last) const; // s spent circling within fixes [first, last]
+    double meanRadius(int first, int last) const; // m, weighted by time; 0 without circling
+    // First run ending at or after a fix, by binary search; runs().end() if none
+    std::vector<CirclingRun>::const_iterator firstOverlap(int first) const;
+
+private:
+    std::vector<int> time;
+    std::vector<CirclingRun> circles;
+};
+
+#endif // CIRCLINGINDEX_H
@@ -0,0 +1,48 @@
+// Runtime table over the distance model policies
+#include "distancemodel.h"
+#include <algorithm>
+
+namespace {
+
+template<typename Model>
+double pairDistance(double lat1, double lon1, double lat2, double lon2) {
+    return Model::distance(Model::point(lat1, lon1), Model::point(lat2, lon2));
+}
+
+template<typename Model>
+void consecutiveDistances(QSpan<const double> latitudes, QSpan<const double> longitudes, QSpan<double> out) {
+    const qsizetype count = std::min({latitudes.size() - 1, longitudes.size() - 1, out.size()});
+    if (count <= 0) return;
+    typename Model::Point previous = Model::point(latitudes[0], longitudes[0]);
+    for (qsizetype i = 0; i < count; i++) {
+        const typename Model::Point next = Model::point(latitudes[i + 1], longitudes[i + 1]);
+        out[i] = Model::distance(previous, next);
+        previous = next;
+    }
+}
+
+// The sphere has batch kernels of its own
+template<>
+void consecutiveDistances<DistanceModels::FAISphere>(QSpan<const double> latitudes, QSpan<const double> longitudes,
+                                                     QSpan<double> out) {
+    Geodesy::consecutiveDistances(Geodesy::FixTerms(latitudes, longitudes), 0, out);
+}
+
+template<typename Model>
+constexpr DistanceModels::Entry makeEntry(const char *name) {
+    return {Model::model, name, &pairDistance<Model>, &consecutiveDistances<Model>};
+}
+
+// Indexed by DistanceModel
+const DistanceModels::Entry Entries[] = {
+    makeEntry<DistanceModels::FAISphere>("FAI sphere"),
+    makeEntry<DistanceModels::WGS84>("WGS84"),
+    makeEntry<DistanceModels::Flat>("Flat"),
+};
+
+}
+
+const DistanceModels::Entry &DistanceModels::entry(DistanceModel model) {
+    const int index = int(model);
+    return Entries[index >= 0 && index < int(std::size(Entries)) ? index : 0];
+}
@@ -0,0 +1,150 @@
+#ifndef DISTANCEMODEL_H
+#define DISTANCEMODEL_H
+
+#include "geodesy.h"
+#include <QSpan>
+#include <QString>
+#include <QtMath>
+#include <cmath>
+
+// Earth models used for scored distances. Leagues differ: the FAI sphere is
+// the common default, WGS84 is asked for in some official submissions, and
+// the flat approximation is for quick previews.
+enum class DistanceModel {
+    FAISphere,
+    WGS84,
+    Flat
+};
+
+// Distance model policies for the optimizers and the analysis code.
+//
+// Each policy converts a fix once to a Point, then measures km between two
+// points with inline arithmetic, so a template instantiated on a policy has
+// no dispatch in its inner loops. SphereRatio, when positive, bounds the
+// model's distance over the FAI sphere distance between the same fixes, so
+// sphere-based bounds (TrackProjection) can be reused; 0 means no such bound.
+namespace DistanceModels {
+
+// Great circle on the 6371 km sphere, from the chord between unit vectors
+struct FAISphere {
+    static constexpr DistanceModel model = DistanceModel::FAISphere;
+    static constexpr double SphereRatio = 1.0;
+
+    struct Point {
+        double x, y, z;
+    };
+
+    static Point point(double latitude, double longitude) {
+        const double lat = qDegreesToRadians(latitude);
+        const double lon = qDegreesToRadians(longitude);
+        return {std::cos(lat) * std::cos(lon), std::cos(lat) * std::sin(lon), std::sin(lat)};
+    }
+    static double distance(const Point &a, const Point &b) {
+        const double dx = a.x - b.x;
+        const double dy = a.y - b.y;
+        const double dz = a.z - b.z;
+        const double half = std::min(1.0, 0.5 * std::sqrt(dx * dx + dy * dy + dz * dz));
+        return 2.0 * Geodesy::EarthRadius * std::asin(half);
+    }
+};
+
+// Geodesic on the WGS84 ellipsoid by Vincenty's inverse method (0.1 mm).
+// Nearly antipodal pairs, where the iteration may not settle, keep the last
+// iterate; flights never get there.
+struct WGS84 {
+    static constexpr DistanceModel model = DistanceModel::WGS84;
+    // Largest radius of curvature (polar, 6399.6 km) over the sphere's
+    static constexpr double SphereRatio = 1.0045;
+    static constexpr double A = 6378.137;                   // km
+    static constexpr double F = 1.0 / 298.257223563;
+    static constexpr double B = A * (1.0 - F);
+
+    struct Point {
+        double sinU, cosU;  // reduced latitude
+        double lon;         // radians
+    };
+
+    static Point point(double latitude, double longitude) {
+        const double u = std::atan((1.0 - F) * std::tan(qDegreesToRadians(latitude)));
+        return {std::sin(u), std::cos(u), qDegreesToRadians(longitude)};
+    }
+    static double distance(const Point &a, const Point &b) {
+        const double l = b.lon - a.lon;
+        double lambda = l;
+        double sinSigma = 0.0, cosSigma = 1.0, sigma = 0.0, cos2Alpha = 1.0, cos2SigmaM = 0.0;
+        for (int iteration = 0; iteration < 100; iteration++) {
+            const double sinLambda = std::sin(lambda);
+            const double cosLambda = std::cos(lambda);
+            const double p = b.cosU * sinLambda;
+            const double q = a.cosU * b.sinU - a.sinU * b.cosU * cosLambda;
+            sinSigma = std::sqrt(p * p + q * q);
+            if (sinSigma == 0.0) return 0.0; // coincident
+            cosSigma = a.sinU * b.sinU + a.cosU * b.cosU * cosLambda;
+            sigma = std::atan2(sinSigma, cosSigma);
+            const double sinAlpha = a.cosU * b.cosU * sinLambda / sinSigma;
+            cos2Alpha = 1.0 - sinAlpha * sinAlpha;
+            cos2SigmaM = cos2Alpha != 0.0 ? cosSigma - 2.0 * a.sinU * b.sinU / cos2Alpha : 0.0; // equatorial line
+            const double c = F / 16.0 * cos2Alpha * (4.0 + F * (4.0 - 3.0 * cos2Alpha));
+            const double previous = lambda;
+            lambda = l + (1.0 - c) * F * sinAlpha *
+                     (sigma + c * sinSigma * (cos2SigmaM + c * cosSigma * (-1.0 + 2.0 * cos2SigmaM * cos2SigmaM)));
+            if (std::abs(lambda - previous) < 1e-12) break;
+        }
+        const double u2 = cos2Alpha * (A * A - B * B) / (B * B);
+        const double bigA = 1.0 + u2 / 16384.0 * (4096.0 + u2 * (-768.0 + u2 * (320.0 - 175.0 * u2)));
+        const double bigB = u2 / 1024.0 * (256.0 + u2 * (-128.0 + u2 * (74.0 - 47.0 * u2)));
+        const double deltaSigma = bigB * sinSigma *
+            (cos2SigmaM + bigB / 4.0 * (cosSigma * (-1.0 + 2.0 * cos2SigmaM * cos2SigmaM) -
+                                        bigB / 6.0 * cos2SigmaM * (-3.0 + 4.0 * sinSigma * sinSigma) *
+                                            (-3.0 + 4.0 * cos2SigmaM * cos2SigmaM)));
+        return B * bigA * (sigma - deltaSigma);
+    }
+};
+
+// Equirectangular approximation on the FAI sphere, using the mean of the two
+// latitude cosines; trig-free per pair, good to about 0.1% over 100 km
+struct Flat {
+    static constexpr DistanceModel model = DistanceModel::Flat;
+    static constexpr double SphereRatio = 0.0;
+
+    struct Point {
+        double lat, lon;    // radians
+        double cosLat;
+    };
+
+    static Point point(double latitude, double longitude) {
+        const double lat = qDegreesToRadians(latitude);
+        return {lat, qDegreesToRadians(longitude), std::cos(lat)};
+    }
+    static double distance(const Point &a, const Point &b) {
+        const double dx = (b.lon - a.lon) * 0.5 * (a.cosLat + b.cosLat);
+        const double dy = b.lat - a.lat;
+        return Geodesy::EarthRadius * std::sqrt(dx * dx + dy * dy);
+    }
+};
+
+// Calls visitor(Policy()) for the selected model: the one runtime branch,
+// taken outside the loops
+template<typename Visitor>
+decltype(auto) visit(DistanceModel model, Visitor &&visitor) {
+    switch (model) {
+    case DistanceModel::WGS84: return visitor(WGS84());
+    case DistanceModel::Flat: return visitor(Flat());
+    case DistanceModel::FAISphere: break;
+    }
+    return visitor(FAISphere());
+}
+
+// Per-model entry points for code that is not itself a template
+struct Entry {
+    DistanceModel model;
+    const char *name;
+    double (*distance)(double lat1, double lon1, double lat2, double lon2);          // km
+    void (*consecutive)(QSpan<const double> latitudes, QSpan<const double> longitudes,
+                        QSpan<double> out);                                           // km, fix i to i + 1
+};
+const Entry &entry(DistanceModel model);
+
+}
+
+#endif // DISTANCEMODEL_H
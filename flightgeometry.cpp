@@ -0,0 +1,117 @@
+// Flight extent queries over the convex hull
+#include "flightgeometry.h"
+#include "geodesy.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+FlightHull::FlightHull(QSpan<const double> latitudes, QSpan<const double> longitudes) {
+    const int count = int(std::min(latitudes.size(), longitudes.size()));
+    if (count == 0) return;
+
+    double centre = 0.0;
+    for (int i = 0; i < count; i++) centre += latitudes[i];
+    const double cosLat = std::cos(qDegreesToRadians(centre / count));
+
+    std::vector<int> order(static_cast<size_t>(count));
+    for (int i = 0; i < count; i++) order[size_t(i)] = i;
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return longitudes[a] != longitudes[b] ? longitudes[a] < longitudes[b] : latitudes[a] < latitudes[b];
+    });
+    order.erase(std::unique(order.begin(), order.end(), [&](int a, int b) {
+        return longitudes[a] == longitudes[b] && latitudes[a] == latitudes[b];
+    }), order.end());
+
+    auto cross = [&](int o, int a, int b) {
+        return (longitudes[a] - longitudes[o]) * cosLat * (latitudes[b] - latitudes[o]) -
+               (latitudes[a] - latitudes[o]) * (longitudes[b] - longitudes[o]) * cosLat;
+    };
+
+    // Monotone chain: lower then upper hull, counter-clockwise
+    if (order.size() < 3) {
+        vertices = order;
+    } else {
+        vertices.resize(2 * order.size());
+        size_t size = 0;
+        for (int index : order) {
+            while (size >= 2 && cross(vertices[size - 2], vertices[size - 1], index) <= 0.0) size--;
+            vertices[size++] = index;
+        }
+        const size_t lower = size + 1;
+        for (auto it = order.rbegin() + 1; it != order.rend(); ++it) {
+            while (size >= lower && cross(vertices[size - 2], vertices[size - 1], *it) <= 0.0) size--;
+            vertices[size++] = *it;
+        }
+        vertices.resize(size - 1); // last point repeats the first
+    }
+
+    std::vector<double> latitude;
+    std::vector<double> longitude;
+    for (int index : vertices) {
+        latitude.push_back(latitudes[index]);
+        longitude.push_back(longitudes[index]);
+        x.push_back(longitudes[index] * cosLat);
+        y.push_back(latitudes[index]);
+    }
+    terms = Geodesy::FixTerms(latitude, longitude);
+}
+
+double FlightHull::distance(int a, int b) const {
+    return terms.distance(a, b);
+}
+
+int FlightHull::farthestFrom(double pointLatitude, double pointLongitude, double &distance) const {
+    std::vector<double> distances(vertices.size());
+    Geodesy::distancesFrom(pointLatitude, pointLongitude, terms, 0, distances);
+
+    int farthest = -1;
+    distance = 0.0;
+    for (size_t i = 0; i < vertices.size(); i++) {
+        if (farthest < 0 || distances[i] > distance) {
+            distance = distances[i];
+            farthest = vertices[i];
+        }
+    }
+    return farthest;
+}
+
+double FlightHull::diameter(int *first, int *second) const {
+    if (!diameterValid) {
+        diameterValid = true;
+        const int count = int(vertices.size());
+        if (count == 1) {
+            diameterPair = {vertices[0], vertices[0]};
+        } else if (count == 2) {
+            diameterDistance = distance(0, 1);
+            diameterPair = {vertices[0], vertices[1]};
+        } else if (count > 2) {
+            // Rotating calipers: for each edge, advance the opposite vertex
+            // while it moves away from the edge, and try every antipodal pair
+            auto area = [this](int a, int b, int c) {
+                return std::abs((x[size_t(b)] - x[size_t(a)]) * (y[size_t(c)] - y[size_t(a)]) -
+                                (y[size_t(b)] - y[size_t(a)]) * (x[size_t(c)] - x[size_t(a)]));
+            };
+            auto consider = [this](int a, int b) {
+                const double d = distance(a, b);
+                if (d > diameterDistance) {
+                    diameterDistance = d;
+                    diameterPair = {vertices[size_t(a)], vertices[size_t(b)]};
+                }
+            };
+
+            int opposite = 1;
+            for (int i = 0; i < count; i++) {
+                const int next = (i + 1) % count;
+                while (area(i, next, (opposite + 1) % count) > area(i, next, opposite)) {
+                    opposite = (opposite + 1) % count;
+                }
+                consider(i, opposite);
+                consider(next, opposite);
+            }
+        }
+    }
+
+    if (first) *first = diameterPair.first;
+    if (second) *second = diameterPair.second;
+    return diameterDistance;
+}
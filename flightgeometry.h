@@ -0,0 +1,42 @@
+#ifndef FLIGHTGEOMETRY_H
+#define FLIGHTGEOMETRY_H
+
+#include "geodesy.h"
+#include <QSpan>
+#include <utility>
+#include <vector>
+
+// Convex hull of a flight, built once, for extent queries.
+//
+// The farthest fix from any point is a hull vertex, and the two fixes
+// farthest apart are an antipodal pair of hull vertices, so both queries
+// cost O(hull size) - usually a few dozen vertices - instead of a pass over
+// the track. The hull is taken in a local equirectangular projection around
+// the track centre; distances are great-circle (km) between the actual fixes.
+class FlightHull {
+public:
+    FlightHull() = default;
+    FlightHull(QSpan<const double> latitudes, QSpan<const double> longitudes);
+
+    bool isEmpty() const { return vertices.empty(); }
+    const std::vector<int>& indices() const { return vertices; } // counter-clockwise
+
+    // Farthest fix from a point; returns its index (-1 if empty)
+    int farthestFrom(double latitude, double longitude, double &distance) const;
+    // The two fixes farthest apart, by rotating calipers; cached
+    double diameter(int *first = nullptr, int *second = nullptr) const;
+
+private:
+    double distance(int a, int b) const; // between hull vertices, km
+
+    std::vector<int> vertices;      // track indices
+    Geodesy::FixTerms terms;        // per vertex
+    std::vector<double> x;          // projected, per vertex
+    std::vector<double> y;
+
+    mutable bool diameterValid = false;
+    mutable double diameterDistance = 0.0;
+    mutable std::pair<int, int> diameterPair{-1, -1};
+};
+
+#endif // FLIGHTGEOMETRY_H
@@ -0,0 +1,140 @@
+// Fused pass over the track for the derived columns and flight figures
+#include "flightmetrics.h"
+#include "kernels.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+const int BlockSize = 512;      // fixes per block; the scratch rows stay in L1
+const int TakeoffSearch = 200;  // s searched for the start of the climb
+const int TakeoffWindow = 20;   // s after a candidate; half its fixes must climb
+
+// Speeds and distances only count over gaps of 1-29 seconds
+bool plausibleGap(int seconds) {
+    return seconds > 0 && seconds < 30;
+}
+
+// First fix followed by a sustained climb, or the first fix
+int findTakeoffAltitude(QSpan<const int> times, QSpan<const double> verticalSpeeds, QSpan<const int> altitudes) {
+    const qsizetype count = verticalSpeeds.size();
+    for (qsizetype i = 0; i < count && times[i] - times[0] < TakeoffSearch; i++) {
+        int windowCount = 0;
+        int positiveCount = 0;
+        for (qsizetype j = i; j < count && times[j] - times[i] < TakeoffWindow; j++) {
+            windowCount++;
+            if (verticalSpeeds[j] > 0.3) positiveCount++;
+        }
+        if (2 * positiveCount >= windowCount) return altitudes[i];
+    }
+    return altitudes[0];
+}
+
+}
+
+FlightMetrics FlightMetrics::compute(FlightTrack &track, const Geodesy::FixTerms &terms,
+                                     const TrackProjection &plane, DistanceModel model, const VarioFilter &filter) {
+    FlightMetrics metrics;
+    const qsizetype count = qsizetype(track.size());
+    if (count == 0) return metrics;
+
+    const FlightTrack &fixes = track;
+    auto times = fixes.times();
+    auto altitudes = fixes.gpsAltitudes();
+    auto latitudes = fixes.latitudes();
+    auto longitudes = fixes.longitudes();
+    auto verticalSpeeds = track.verticalSpeeds();
+    auto groundSpeeds = track.groundSpeeds();
+    auto courses = track.courses();
+
+    const Kernels::Table &kernels = Kernels::active();
+    const DistanceModels::Entry &distances = DistanceModels::entry(model);
+    const bool sphere = model == DistanceModel::FAISphere; // legs straight from the shared terms
+
+    // The vario filter's windows span blocks, so it runs first as its own
+    // stage; the block loop below only reads its output
+    filter.apply(times, altitudes, verticalSpeeds);
+
+    // Scratch rows, reused by every block
+    std::vector<double> legs(BlockSize);
+    std::vector<double> bearings(BlockSize);
+    std::vector<double> fromTakeoff(BlockSize);
+
+    double speedSum = 0.0;
+    int speedCount = 0;
+    double farthest = -1.0; // km on the sphere
+    WindEstimator wind;
+    metrics.minAltitude = metrics.maxAltitude = altitudes[0];
+
+    for (qsizetype begin = 0; begin < count; begin += BlockSize) {
+        const qsizetype end = std::min(count, begin + BlockSize);
+
+        // Legs ending at fixes [max(begin, 1), end), the first from fix legFirst
+        const qsizetype legFirst = std::max<qsizetype>(begin, 1) - 1;
+        const qsizetype legCount = end - 1 - legFirst;
+        if (legCount > 0) {
+            const QSpan<double> legRow(legs.data(), legCount);
+            if (sphere) {
+                Geodesy::consecutiveDistances(terms, int(legFirst), legRow);
+            } else {
+                distances.consecutive(latitudes.subspan(legFirst, legCount + 1),
+                                      longitudes.subspan(legFirst, legCount + 1), legRow);
+            }
+            Geodesy::consecutiveBearings(terms, int(legFirst), QSpan<double>(bearings.data(), legCount));
+        }
+        Geodesy::distancesFrom(latitudes[0], longitudes[0], terms, int(begin),
+                               QSpan<double>(fromTakeoff.data(), end - begin));
+
+        for (qsizetype i = begin; i < end; i++) {
+            groundSpeeds[i] = 0;
+            if (i > 0 && plausibleGap(times[i] - times[i-1])) {
+                const size_t leg = size_t(i - 1 - legFirst);
+
+                // Plane distance in metres, well inside GPS noise at flight
+                // scale; ~100 km/h is the most a paraglider makes in strong wind
+                const double speed = std::clamp(plane.distance(int(i - 1), int(i)) / (times[i] - times[i-1]), 0.0, 28.0);
+                groundSpeeds[i] = speed;
+                courses[i] = bearings[leg];
+                wind.add(times[i], altitudes[i], speed, courses[i]);
+
+                // Only count reasonable speeds for the average
+                if (speed > 0 && speed < 25.0) {
+                    metrics.maxGroundSpeed = std::max(metrics.maxGroundSpeed, speed);
+                    speedSum += speed;
+                    speedCount++;
+                }
+
+                // Skip unrealistic jumps (probably GPS errors)
+                if (legs[leg] < 1.0) metrics.totalDistance += legs[leg];
+            } else {
+                wind.gap();
+            }
+
+            metrics.minAltitude = std::min(metrics.minAltitude, altitudes[i]);
+            metrics.maxAltitude = std::max(metrics.maxAltitude, altitudes[i]);
+            if (fromTakeoff[size_t(i - begin)] > farthest) {
+                farthest = fromTakeoff[size_t(i - begin)];
+                metrics.farthestFix = int(i);
+            }
+        }
+
+        double low, high;
+        kernels.minMax(verticalSpeeds.data() + begin, end - begin, low, high);
+        metrics.minVario = begin == 0 ? low : std::min(metrics.minVario, low);
+        metrics.maxVario = begin == 0 ? high : std::max(metrics.maxVario, high);
+    }
+
+    metrics.wind = wind.samples();
+    metrics.takeoffAltitude = findTakeoffAltitude(times, verticalSpeeds, altitudes);
+    metrics.averageGroundSpeed = speedCount > 0 ? speedSum / speedCount : 0;
+    if (count >= 2) {
+        metrics.straightLineDistance = distances.distance(latitudes[0], longitudes[0],
+                                                          latitudes[count-1], longitudes[count-1]);
+        metrics.durationSeconds = times[count-1] - times[0];
+    }
+
+    // The sphere picks the farthest fix, the model measures it
+    metrics.maximumDistance = distances.distance(latitudes[0], longitudes[0],
+                                                 latitudes[metrics.farthestFix], longitudes[metrics.farthestFix]);
+    return metrics;
+}
@@ -0,0 +1,40 @@
+#ifndef FLIGHTMETRICS_H
+#define FLIGHTMETRICS_H
+
+#include "distancemodel.h"
+#include "flighttrack.h"
+#include "geodesy.h"
+#include "trackprojection.h"
+#include "variofilter.h"
+#include "windestimator.h"
+#include <vector>
+
+// Derived per-fix columns and whole-flight figures from one pass.
+//
+// The vario column comes from the configured filter first. The track is then
+// walked once in blocks small enough to stay in L1: for each block the batch
+// kernels fill leg distances, courses and distances from takeoff, then a
+// single loop derives ground speed into the track columns and folds every
+// running figure below, the wind estimate included.
+struct FlightMetrics {
+    double maxVario = 0.0;              // m/s, smoothed
+    double minVario = 0.0;              // m/s
+    double maxGroundSpeed = 0.0;        // m/s, over plausible legs
+    double averageGroundSpeed = 0.0;    // m/s
+    double totalDistance = 0.0;         // km, sum of plausible legs
+    double straightLineDistance = 0.0;  // km, takeoff to landing
+    double maximumDistance = 0.0;       // km, farthest fix from takeoff
+    int farthestFix = -1;
+    int takeoffAltitude = 0;            // m, where sustained climb starts
+    int minAltitude = 0;                // m, GPS
+    int maxAltitude = 0;                // m
+    int durationSeconds = 0;
+    std::vector<WindSample> wind;       // one per fix that closed a circling turn
+
+    // Fills the track's vertical speed, ground speed and course columns;
+    // distances are measured in the given model, speeds in the plane
+    static FlightMetrics compute(FlightTrack &track, const Geodesy::FixTerms &terms, const TrackProjection &plane,
+                                 DistanceModel model, const VarioFilter &filter = VarioFilter());
+};
+
+#endif // FLIGHTMETRICS_H
@@ -0,0 +1,69 @@
+// Columnar flight track storage
+#include "flighttrack.h"
+
+void FlightTrack::clear() {
+    time.clear();
+    latitude.clear();
+    longitude.clear();
+    pressureAltitude.clear();
+    gpsAltitude.clear();
+    verticalSpeed.clear();
+    groundSpeed.clear();
+    course.clear();
+}
+
+void FlightTrack::reserve(size_t count) {
+    time.reserve(count);
+    latitude.reserve(count);
+    longitude.reserve(count);
+    pressureAltitude.reserve(count);
+    gpsAltitude.reserve(count);
+    verticalSpeed.reserve(count);
+    groundSpeed.reserve(count);
+    course.reserve(count);
+}
+
+void FlightTrack::resize(size_t count) {
+    time.resize(count);
+    latitude.resize(count);
+    longitude.resize(count);
+    pressureAltitude.resize(count);
+    gpsAltitude.resize(count);
+    verticalSpeed.resize(count);
+    groundSpeed.resize(count);
+    course.resize(count);
+}
+
+void FlightTrack::append(const IGCPoint &point) {
+    time.push_back(point.time);
+    latitude.push_back(point.latitude);
+    longitude.push_back(point.longitude);
+    pressureAltitude.push_back(point.pressureAltitude);
+    gpsAltitude.push_back(point.gpsAltitude);
+    verticalSpeed.push_back(point.verticalSpeed);
+    groundSpeed.push_back(point.groundSpeed);
+    course.push_back(point.course);
+}
+
+IGCPoint FlightTrack::point(size_t index) const {
+    IGCPoint point;
+    point.time = time[index];
+    point.latitude = latitude[index];
+    point.longitude = longitude[index];
+    point.pressureAltitude = pressureAltitude[index];
+    point.gpsAltitude = gpsAltitude[index];
+    point.verticalSpeed = verticalSpeed[index];
+    point.groundSpeed = groundSpeed[index];
+    point.course = course[index];
+    point.isValid = true;
+    return point;
+}
+
+std::vector<IGCPoint> FlightTrack::toPoints() const {
+    std::vector<IGCPoint> points;
+    points.reserve(size());
+    for (size_t i = 0; i < size(); i++) {
+        points.push_back(point(i));
+    }
+    return points;
+}
@@ -0,0 +1,74 @@
+#ifndef FLIGHTTRACK_H
+#define FLIGHTTRACK_H
+
+#include <QSpan>
+#include <vector>
+
+struct IGCPoint {
+    double latitude = 0.0;
+    double longitude = 0.0;
+    double verticalSpeed = 0.0;  // m/s
+    double groundSpeed = 0.0;    // m/s
+    double course = 0.0;         // degrees
+    int time = 0;                // seconds since the flight epoch (UTC)
+    int pressureAltitude = 0;
+    int gpsAltitude = 0;
+    bool isValid = false;
+};
+
+// Columnar flight storage: one contiguous array per field, so a pass over
+// one quantity (altitude, vario, ...) streams only that quantity. Every
+// stored fix is valid.
+class FlightTrack {
+public:
+    size_t size() const { return time.size(); }
+    bool empty() const { return time.empty(); }
+
+    void clear();
+    void reserve(size_t count);
+    void resize(size_t count);
+    void append(const IGCPoint &point);
+
+    // Recorded fields
+    QSpan<const int> times() const { return view(time); }
+    QSpan<const double> latitudes() const { return view(latitude); }
+    QSpan<const double> longitudes() const { return view(longitude); }
+    QSpan<const int> pressureAltitudes() const { return view(pressureAltitude); }
+    QSpan<const int> gpsAltitudes() const { return view(gpsAltitude); }
+
+    QSpan<int> times() { return view(time); }
+    QSpan<double> latitudes() { return view(latitude); }
+    QSpan<double> longitudes() { return view(longitude); }
+    QSpan<int> pressureAltitudes() { return view(pressureAltitude); }
+    QSpan<int> gpsAltitudes() { return view(gpsAltitude); }
+
+    // Derived per-fix values
+    QSpan<const double> verticalSpeeds() const { return view(verticalSpeed); }
+    QSpan<const double> groundSpeeds() const { return view(groundSpeed); }
+    QSpan<const double> courses() const { return view(course); }
+
+    QSpan<double> verticalSpeeds() { return view(verticalSpeed); }
+    QSpan<double> groundSpeeds() { return view(groundSpeed); }
+    QSpan<double> courses() { return view(course); }
+
+    // Row access for code that still wants whole fixes
+    IGCPoint point(size_t index) const;
+    std::vector<IGCPoint> toPoints() const;
+
+private:
+    template<typename T>
+    static QSpan<const T> view(const std::vector<T> &column) { return QSpan<const T>(column.data(), qsizetype(column.size())); }
+    template<typename T>
+    static QSpan<T> view(std::vector<T> &column) { return QSpan<T>(column.data(), qsizetype(column.size())); }
+
+    std::vector<int> time;
+    std::vector<double> latitude;
+    std::vector<double> longitude;
+    std::vector<int> pressureAltitude;
+    std::vector<int> gpsAltitude;
+    std::vector<double> verticalSpeed;
+    std::vector<double> groundSpeed;
+    std::vector<double> course;
+};
+
+#endif // FLIGHTTRACK_H
@@ -0,0 +1,75 @@
+// Scalar and batch geodesic kernels
+#include "geodesy.h"
+#include "kernels.h"
+#include "kernels_p.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace Geodesy {
+
+double distance(double lat1, double lon1, double lat2, double lon2) {
+    // Haversine formula
+    const double lat1Rad = qDegreesToRadians(lat1);
+    const double lat2Rad = qDegreesToRadians(lat2);
+    const double dLat = lat2Rad - lat1Rad;
+    const double dLon = qDegreesToRadians(lon2 - lon1);
+
+    const double a = std::sin(dLat / 2) * std::sin(dLat / 2) +
+                     std::cos(lat1Rad) * std::cos(lat2Rad) * std::sin(dLon / 2) * std::sin(dLon / 2);
+    return EarthRadius * 2 * std::atan2(std::sqrt(a), std::sqrt(1 - a));
+}
+
+double bearing(double lat1, double lon1, double lat2, double lon2) {
+    const double dLon = qDegreesToRadians(lon2 - lon1);
+    const double lat1Rad = qDegreesToRadians(lat1);
+    const double lat2Rad = qDegreesToRadians(lat2);
+
+    const double y = std::sin(dLon) * std::cos(lat2Rad);
+    const double x = std::cos(lat1Rad) * std::sin(lat2Rad) - std::sin(lat1Rad) * std::cos(lat2Rad) * std::cos(dLon);
+    return std::fmod(qRadiansToDegrees(std::atan2(y, x)) + 360.0, 360.0);
+}
+
+FixTerms::FixTerms(QSpan<const double> latitudes, QSpan<const double> longitudes) {
+    const size_t count = size_t(std::min(latitudes.size(), longitudes.size()));
+    cosLat.resize(count);
+    sinLat.resize(count);
+    cosLon.resize(count);
+    sinLon.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        const double lat = qDegreesToRadians(latitudes[i]);
+        const double lon = qDegreesToRadians(longitudes[i]);
+        cosLat[i] = std::cos(lat);
+        sinLat[i] = std::sin(lat);
+        cosLon[i] = std::cos(lon);
+        sinLon[i] = std::sin(lon);
+    }
+}
+
+double FixTerms::distance(int i, int j) const {
+    const double dx = cosLat[size_t(i)] * cosLon[size_t(i)] - cosLat[size_t(j)] * cosLon[size_t(j)];
+    const double dy = cosLat[size_t(i)] * sinLon[size_t(i)] - cosLat[size_t(j)] * sinLon[size_t(j)];
+    const double dz = sinLat[size_t(i)] - sinLat[size_t(j)];
+    return chordToDistance<ScalarOps>(dx * dx + dy * dy + dz * dz);
+}
+
+void consecutiveDistances(const FixTerms &terms, int first, QSpan<double> out) {
+    const int count = int(std::min<qsizetype>(out.size(), terms.size() - first - 1));
+    if (count > 0) Kernels::active().consecutiveDistances(terms, first, out.data(), count);
+}
+
+void consecutiveBearings(const FixTerms &terms, int first, QSpan<double> out) {
+    const int count = int(std::min<qsizetype>(out.size(), terms.size() - first - 1));
+    if (count > 0) Kernels::active().consecutiveBearings(terms, first, out.data(), count);
+}
+
+void distancesFrom(double latitude, double longitude, const FixTerms &terms, int first, QSpan<double> out) {
+    const int count = int(std::min<qsizetype>(out.size(), terms.size() - first));
+    if (count <= 0) return;
+    const double lat = qDegreesToRadians(latitude);
+    const double lon = qDegreesToRadians(longitude);
+    const double origin[4] = {std::cos(lat), std::sin(lat), std::cos(lon), std::sin(lon)};
+    Kernels::active().distancesFrom(origin, terms, first, out.data(), count);
+}
+
+}
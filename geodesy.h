@@ -0,0 +1,48 @@
+#ifndef GEODESY_H
+#define GEODESY_H
+
+#include <QSpan>
+#include <vector>
+
+// Distances and bearings on the FAI sphere, one pair at a time or in
+// batches over a track.
+//
+// The batch kernels work from per-fix sines and cosines computed once
+// (FixTerms), so a pair costs a handful of multiply-adds plus one arcsine,
+// and run two to eight pairs per instruction (see Kernels). Against the
+// scalar reference below, distances agree within 1e-8 km (10 um) and
+// bearings within 1e-6 degrees for fixes at least 1 m apart; the bearing
+// between coincident fixes is undefined in both.
+namespace Geodesy {
+
+constexpr double EarthRadius = 6371.0; // km
+
+// Scalar reference: haversine distance (km) and initial bearing (degrees, [0, 360))
+double distance(double lat1, double lon1, double lat2, double lon2);
+double bearing(double lat1, double lon1, double lat2, double lon2);
+
+// Per-fix trigonometric terms shared by every kernel
+struct FixTerms {
+    std::vector<double> cosLat;
+    std::vector<double> sinLat;
+    std::vector<double> cosLon;
+    std::vector<double> sinLon;
+
+    FixTerms() = default;
+    FixTerms(QSpan<const double> latitudes, QSpan<const double> longitudes);
+    int size() const { return int(cosLat.size()); }
+
+    // Distance between fixes i and j (km), same arithmetic as the kernels
+    double distance(int i, int j) const;
+};
+
+// out[i] = distance from fix first + i to the next; at most size() - first - 1 values
+void consecutiveDistances(const FixTerms &terms, int first, QSpan<double> out);
+// out[i] = bearing from fix first + i to the next
+void consecutiveBearings(const FixTerms &terms, int first, QSpan<double> out);
+// out[i] = distance from (latitude, longitude) to fix first + i
+void distancesFrom(double latitude, double longitude, const FixTerms &terms, int first, QSpan<double> out);
+
+}
+
+#endif // GEODESY_H
@@ -1,77 +1,305 @@
 // Enhanced IGC Analyzer Implementation
 #include "igcanalyzer.h"
+#include "igcparser.h"
+#include "olcoptimizer.h"
 #include <QtMath>
 #include <QDebug>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
 #include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace {
+
+// Maps (date, seconds-of-day) to seconds since the epoch date, adding a day
+// whenever the clock wraps past midnight between consecutive fixes
+class FlightClock {
+public:
+    QDate epochDate;
+
+    int toFlightTime(const QDate &date, int secondsOfDay) {
+        if (!epochDate.isValid()) epochDate = date;
+        if (date != currentDate) {
+            currentDate = date;
+            day = int(epochDate.daysTo(date));
+            lastSeconds = -1;
+        }
+        if (lastSeconds >= 0 && secondsOfDay < lastSeconds - 12 * 3600) {
+            day++;
+        }
+        lastSeconds = secondsOfDay;
+        return day * 86400 + secondsOfDay;
+    }
+
+private:
+    QDate currentDate;
+    int day = 0;
+    int lastSeconds = -1;
+};
+
+}
 
 // IGCAnalyzer Implementation
-IGCAnalyzer::IGCAnalyzer(QObject *parent) : QObject(parent) {
-    flightData.reserve(30000); // Increased for longer flights
+IGCAnalyzer::IGCAnalyzer(QObject *parent) : QObject(parent), scoring(new ScoringEngine(this)) {
+    track.reserve(30000); // Increased for longer flights
+
+    registry.define(DistanceModelSetting, {});
+    registry.define(SearchSettings, {});
+    registry.define(ThermalSettings, {});
+    registry.define(VarioFilterSetting, {});
+    registry.define(ResampleSetting, {});
+    registry.define(Geometry, {}, [this] { computeGeometry(); });
+    registry.define(Hull, {}, [this] { hull = FlightHull(track.latitudes(), track.longitudes()); });
+    registry.define(Resampled, {ResampleSetting}, [this] {
+        resampled = TrackResampler::resample(track, resampleInterval, resampleInterpolation);
+    });
+    registry.define(Summary, {Geometry, DistanceModelSetting, VarioFilterSetting}, [this] { computeSummary(); });
+    registry.define(Scores, {Summary, DistanceModelSetting, SearchSettings}, [this] { computeScores(); });
+    registry.define(Segments, {Summary, Geometry}, [this] {
+        segmentIndex = SegmentIndex(track.times(), track.gpsAltitudes(), track.verticalSpeeds(), plane.xs(), plane.ys());
+    });
+    registry.define(Circling, {Summary}, [this] {
+        circling = CirclingIndex(track.times(), track.courses(), track.groundSpeeds());
+    });
+    registry.define(Phases, {Summary, Geometry, Circling}, [this] {
+        phases = PhaseIndex(track.times(), track.gpsAltitudes(), track.verticalSpeeds(), track.groundSpeeds(),
+                            plane.xs(), plane.ys(), circling);
+    });
+    registry.define(Climbs, {Summary, Geometry, Segments, Circling}, [this] {
+        climbs = ThermalDetector::findClimbs(track.times(), track.verticalSpeeds(), plane.xs(), plane.ys(), segmentIndex,
+                                             circling);
+    });
+    registry.define(Thermals, {Geometry, Climbs, ThermalSettings}, [this] { findThermals(); });
+
+    connect(scoring, &ScoringEngine::distanceModelChanged, this, [this] { registry.invalidate(DistanceModelSetting); });
+    connect(scoring, &ScoringEngine::searchSettingsChanged, this, [this] { registry.invalidate(SearchSettings); });
+}
+
+IGCAnalyzer* IGCAnalyzer::clone(QObject *parent) const {
+    IGCAnalyzer *copy = new IGCAnalyzer(parent);
+
+    // Settings first: they invalidate the copy's registry as they change
+    copy->scoring->setTimeBudget(scoring->getTimeBudget());
+    copy->scoring->setThreadCount(scoring->getThreadCount());
+    copy->scoring->setTolerance(scoring->getTolerance());
+    copy->scoring->setDistanceModel(scoring->getDistanceModel());
+    copy->thermalParameters = thermalParameters;
+    copy->varioFilter = varioFilter;
+    copy->resampleInterval = resampleInterval;
+    copy->resampleInterpolation = resampleInterpolation;
+    copy->parseChunks = parseChunks;
+
+    copy->track = track;
+    copy->hull = hull;
+    copy->fixTerms = fixTerms;
+    copy->plane = plane;
+    copy->segmentIndex = segmentIndex;
+    copy->circling = circling;
+    copy->phases = phases;
+    copy->climbs = climbs;
+    copy->thermals = thermals;
+    copy->resampled = resampled;
+
+    copy->pilotName = pilotName;
+    copy->gliderType = gliderType;
+    copy->gliderID = gliderID;
+    copy->flightDate = flightDate;
+    copy->flightEpoch = flightEpoch;
+    copy->utcOffsetSeconds = utcOffsetSeconds;
+
+    copy->metrics = metrics;
+    copy->olcDistance = olcDistance;
+    copy->reduction = reduction;
+    copy->olcErrorBound = olcErrorBound;
+    copy->olcRoute = olcRoute;
+    copy->flatTriangle = flatTriangle;
+    copy->faiTriangle = faiTriangle;
+
+    copy->registry.copyValidity(registry); // the row view is rebuilt on demand
+    return copy;
+}
+
+const std::vector<IGCPoint>& IGCAnalyzer::getFlightData() const {
+    require(Summary);
+    if (!flightDataViewValid) {
+        flightDataView = track.toPoints();
+        flightDataViewValid = true;
+    }
+    return flightDataView;
 }
 
 bool IGCAnalyzer::loadIGCFile(const QString &fileName) {
     QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (!file.open(QIODevice::ReadOnly)) {
         return false;
     }
 
-    flightData.clear();
-    thermals.clear();
+    track.clear();
+    registry.invalidateAll();
+    flightEpoch = QDateTime();
+    flightDataView.clear();
+    flightDataViewValid = false;
+
+    // Decode straight from the mapped file; fall back to line reading when
+    // the device cannot be mapped
+    const qint64 fileSize = file.size();
+    uchar *mapped = fileSize > 0 ? file.map(0, fileSize) : nullptr;
+    if (mapped) {
+        parseMappedData(reinterpret_cast<const char *>(mapped), fileSize);
+        file.unmap(mapped);
+    } else {
+        parseTextStream(file);
+    }
+
+    return !track.empty();
+}
+
+void IGCAnalyzer::computeGeometry() {
+    fixTerms = Geodesy::FixTerms(track.latitudes(), track.longitudes());
+    plane = TrackProjection(track.latitudes(), track.longitudes());
+}
+
+void IGCAnalyzer::computeSummary() {
+    metrics = FlightMetrics::compute(track, fixTerms, plane, scoring->getDistanceModel(), varioFilter);
+    flightDataViewValid = false; // the rows carry the derived columns
+
+    qDebug() << "Flight stats - Max speed:" << metrics.maxGroundSpeed * 3.6 << "km/h, Avg speed:"
+             << metrics.averageGroundSpeed * 3.6 << "km/h, Total dist:" << metrics.totalDistance << "km";
+}
+
+void IGCAnalyzer::parseMappedData(const char *data, qint64 size) {
+    // Scan large files in parallel; small ones are not worth the threads
+    const qint64 minChunkSize = 256 * 1024;
+    const int chunkCount = parseChunks > 0 ? parseChunks
+                                           : int(qBound<qint64>(1, size / minChunkSize, QThread::idealThreadCount()));
+
+    std::vector<ParsedChunk> chunks = IGCParser::splitChunks(data, size, chunkCount);
+    if (chunks.size() > 1) {
+        QtConcurrent::blockingMap(chunks, [](ParsedChunk &chunk) { IGCParser::scanChunk(chunk); });
+    } else {
+        for (auto &chunk : chunks) IGCParser::scanChunk(chunk);
+    }
+
+    // Apply headers in file order so every run of records gets the date in
+    // effect; records before the first date are dropped
+    struct RecordRun {
+        const BRecord *records;
+        size_t count;
+        QDate date;
+        size_t outputIndex;
+    };
+    std::vector<RecordRun> runs;
+    size_t totalRecords = 0;
+    QDate currentDate;
+    bool dateFound = false;
+
+    auto addRun = [&](const ParsedChunk &chunk, size_t from, size_t to) {
+        if (!dateFound || from >= to) return;
+        runs.push_back({chunk.records.data() + from, to - from, currentDate, totalRecords});
+        totalRecords += to - from;
+    };
+
+    for (const auto &chunk : chunks) {
+        size_t next = 0;
+        for (const auto &header : chunk.headers) {
+            addRun(chunk, next, header.recordIndex);
+            parseHeaderLine(QString::fromLatin1(header.begin, header.end - header.begin), currentDate, dateFound);
+            next = header.recordIndex;
+        }
+        addRun(chunk, next, chunk.records.size());
+    }
+
+    // Fix times need the previous fix for midnight rollover: one cheap
+    // sequential integer pass, then each run fills its own slice
+    track.resize(totalRecords);
+    auto times = track.times();
+    FlightClock clock;
+    for (const auto &run : runs) {
+        for (size_t i = 0; i < run.count; i++) {
+            times[run.outputIndex + i] = clock.toFlightTime(run.date, run.records[i].secondsOfDay);
+        }
+    }
+    if (clock.epochDate.isValid()) {
+        flightEpoch = QDateTime(clock.epochDate, QTime(0, 0), Qt::UTC);
+    }
+
+    auto latitudes = track.latitudes();
+    auto longitudes = track.longitudes();
+    auto pressureAltitudes = track.pressureAltitudes();
+    auto gpsAltitudes = track.gpsAltitudes();
+    auto convertRun = [&](const RecordRun &run) {
+        for (size_t i = 0; i < run.count; i++) {
+            const BRecord &record = run.records[i];
+            const size_t index = run.outputIndex + i;
+            latitudes[index] = IGCParser::toDegrees(record.latitude);
+            longitudes[index] = IGCParser::toDegrees(record.longitude);
+            pressureAltitudes[index] = record.pressureAltitude;
+            gpsAltitudes[index] = record.gpsAltitude;
+        }
+    };
+    if (chunks.size() > 1) {
+        QtConcurrent::blockingMap(runs, convertRun);
+    } else {
+        for (const auto &run : runs) convertRun(run);
+    }
+}
 
+void IGCAnalyzer::parseTextStream(QFile &file) {
     QTextStream in(&file);
     QDate currentDate;
     bool dateFound = false;
+    FlightClock clock;
 
     while (!in.atEnd()) {
         QString line = in.readLine().trimmed();
 
-        if (line.startsWith("HFDTE") || line.startsWith("HFDTEDATE:")) {
-            // Parse date - handle both HFDTE and HFDTEDATE formats
-            QString dateStr = line.contains("DATE:") ? line.mid(line.indexOf("DATE:") + 5) : line.mid(5);
-            dateStr = dateStr.split(',')[0];
-            if (dateStr.length() >= 6) {
-                int day = dateStr.mid(0, 2).toInt();
-                int month = dateStr.mid(2, 2).toInt();
-                int year = 2000 + dateStr.mid(4, 2).toInt();
-                currentDate = QDate(year, month, day);
-                flightDate = QDateTime(currentDate, QTime());
-                dateFound = true;
-            }
-        }
-        else if (line.startsWith("HFPLT") || line.startsWith("HFPLTPILOTINCHARGE:")) {
-            QString pilot = line.contains("PILOTINCHARGE:") ?
-                                line.mid(line.indexOf("PILOTINCHARGE:") + 14) : line.mid(5);
-            if (!pilot.isEmpty()) pilotName = pilot;
-        }
-        else if (line.startsWith("HFGTY") || line.startsWith("HFGTYGLIDERTYPE:")) {
-            QString glider = line.contains("GLIDERTYPE:") ?
-                                 line.mid(line.indexOf("GLIDERTYPE:") + 11) : line.mid(5);
-            if (!glider.isEmpty()) gliderType = glider;
-        }
-        else if (line.startsWith("HFGID") || line.startsWith("HFGIDGLIDERID:")) {
-            QString gid = line.contains("GLIDERID:") ?
-                              line.mid(line.indexOf("GLIDERID:") + 9) : line.mid(5);
-            if (!gid.isEmpty()) gliderID = gid;
+        if (line.startsWith("H")) {
+            parseHeaderLine(line, currentDate, dateFound);
         }
         else if (line.startsWith("B") && dateFound) {
             IGCPoint point = parseIGCLine(line);
             if (point.isValid) {
-                point.timestamp = parseIGCTime(line.mid(1, 6), currentDate);
-                flightData.push_back(point);
+                point.time = clock.toFlightTime(currentDate, parseIGCTime(line.mid(1, 6)));
+                track.append(point);
             }
         }
     }
 
-    if (!flightData.empty()) {
-        calculateVerticalSpeeds();
-        calculateGroundSpeeds();
-        calculateFlightStatistics(); // New method for comprehensive stats
-        calculateOLCDistance();      // Calculate OLC optimization
-        calculateMaximumDistance();  // Calculate maximum distance
-        return true;
+    if (clock.epochDate.isValid()) {
+        flightEpoch = QDateTime(clock.epochDate, QTime(0, 0), Qt::UTC);
     }
+}
 
-    return false;
+void IGCAnalyzer::parseHeaderLine(const QString &line, QDate &currentDate, bool &dateFound) {
+    if (line.startsWith("HFDTE") || line.startsWith("HFDTEDATE:")) {
+        // Parse date - handle both HFDTE and HFDTEDATE formats
+        QString dateStr = line.contains("DATE:") ? line.mid(line.indexOf("DATE:") + 5) : line.mid(5);
+        dateStr = dateStr.split(',')[0];
+        if (dateStr.length() >= 6) {
+            int day = dateStr.mid(0, 2).toInt();
+            int month = dateStr.mid(2, 2).toInt();
+            int year = 2000 + dateStr.mid(4, 2).toInt();
+            currentDate = QDate(year, month, day);
+            flightDate = QDateTime(currentDate, QTime());
+            dateFound = true;
+        }
+    }
+    else if (line.startsWith("HFPLT") || line.startsWith("HFPLTPILOTINCHARGE:")) {
+        QString pilot = line.contains("PILOTINCHARGE:") ?
+                            line.mid(line.indexOf("PILOTINCHARGE:") + 14) : line.mid(5);
+        if (!pilot.isEmpty()) pilotName = pilot;
+    }
+    else if (line.startsWith("HFGTY") || line.startsWith("HFGTYGLIDERTYPE:")) {
+        QString glider = line.contains("GLIDERTYPE:") ?
+                             line.mid(line.indexOf("GLIDERTYPE:") + 11) : line.mid(5);
+        if (!glider.isEmpty()) gliderType = glider;
+    }
+    else if (line.startsWith("HFGID") || line.startsWith("HFGIDGLIDERID:")) {
+        QString gid = line.contains("GLIDERID:") ?
+                          line.mid(line.indexOf("GLIDERID:") + 9) : line.mid(5);
+        if (!gid.isEmpty()) gliderID = gid;
+    }
 }
 
 IGCPoint IGCAnalyzer::parseIGCLine(const QString &line) {
@@ -82,12 +310,12 @@ IGCPoint IGCAnalyzer::parseIGCLine(const QString &line) {
     }
 
     try {
-        // Parse latitude (positions 7-13: DDMMMMMN)
-        QString latStr = line.mid(7, 7);
+        // Parse latitude (positions 7-14: DDMMmmmN)
+        QString latStr = line.mid(7, 8);
         point.latitude = parseCoordinate(latStr, true);
 
-        // Parse longitude (positions 15-22: DDDMMMMMW)
-        QString lonStr = line.mid(15, 8);
+        // Parse longitude (positions 15-23: DDDMMmmmE)
+        QString lonStr = line.mid(15, 9);
         point.longitude = parseCoordinate(lonStr, false);
 
         // Parse altitudes
@@ -103,38 +331,34 @@ IGCPoint IGCAnalyzer::parseIGCLine(const QString &line) {
     return point;
 }
 
-QDateTime IGCAnalyzer::parseIGCTime(const QString &timeStr, const QDate &date) {
+int IGCAnalyzer::parseIGCTime(const QString &timeStr) {
     int hour = timeStr.mid(0, 2).toInt();
     int minute = timeStr.mid(2, 2).toInt();
     int second = timeStr.mid(4, 2).toInt();
 
-    QTime time(hour, minute, second);
-    QDateTime utcTime = QDateTime(date, time, Qt::UTC);
-
-    // Convert to local time (UTC+3 for Turkey)
-    return utcTime.addSecs(3 * 3600);
+    return hour * 3600 + minute * 60 + second; // Seconds of day (UTC)
 }
 
 double IGCAnalyzer::parseCoordinate(const QString &coord, bool isLatitude) {
     if (isLatitude) {
-        // Format: DDMMMMMN/S (e.g., 4012345N)
-        if (coord.length() < 7) return 0.0;
+        // Format: DDMMmmmN/S (e.g., 4012345N)
+        if (coord.length() < 8) return 0.0;
 
         int degrees = coord.mid(0, 2).toInt();
         double minutes = coord.mid(2, 5).toDouble() / 1000.0; // 5 digits for decimal minutes
-        char hemisphere = coord.at(6).toLatin1();
+        char hemisphere = coord.at(7).toLatin1();
 
         double result = degrees + minutes / 60.0;
         if (hemisphere == 'S') result = -result;
 
         return result;
     } else {
-        // Format: DDDMMMMMW/E (e.g., 02912345E)
-        if (coord.length() < 8) return 0.0;
+        // Format: DDDMMmmmE/W (e.g., 02912345E)
+        if (coord.length() < 9) return 0.0;
 
         int degrees = coord.mid(0, 3).toInt();
         double minutes = coord.mid(3, 5).toDouble() / 1000.0; // 5 digits for decimal minutes
-        char hemisphere = coord.at(7).toLatin1();
+        char hemisphere = coord.at(8).toLatin1();
 
         double result = degrees + minutes / 60.0;
         if (hemisphere == 'W') result = -result;
@@ -143,411 +367,113 @@ double IGCAnalyzer::parseCoordinate(const QString &coord, bool isLatitude) {
     }
 }
 
-void IGCAnalyzer::calculateVerticalSpeeds() {
-    if (flightData.size() < 2) return;
-
-    flightData[0].verticalSpeed = 0;
-    std::vector<double> rawSpeeds(flightData.size(), 0);
-
-    // Calculate raw vertical speeds
-    for (size_t i = 1; i < flightData.size(); i++) {
-        qint64 timeDiff = flightData[i-1].timestamp.msecsTo(flightData[i].timestamp);
-        if (timeDiff > 0 && timeDiff < 30000) { // Ignore gaps > 30 seconds
-            double altDiff = flightData[i].gpsAltitude - flightData[i-1].gpsAltitude;
-            double rawVSpeed = (altDiff * 1000.0) / timeDiff; // m/s
-
-            // Initial clamping for obviously wrong values
-            if (rawVSpeed > 25.0) rawVSpeed = 25.0;
-            if (rawVSpeed < -35.0) rawVSpeed = -35.0;
-
-            rawSpeeds[i] = rawVSpeed;
-        }
-    }
-
-    // Apply very light smoothing to preserve actual peaks
-    int windowSize = 3; // Small window
-    std::vector<double> smoothedSpeeds(flightData.size());
-
-    for (size_t i = 0; i < flightData.size(); i++) {
-        int start = std::max(0, (int)i - windowSize/2);
-        int end = std::min((int)flightData.size() - 1, (int)i + windowSize/2);
-
-        double sum = 0;
-        int count = 0;
-        for (int j = start; j <= end; j++) {
-            sum += rawSpeeds[j];
-            count++;
-        }
-        smoothedSpeeds[i] = count > 0 ? sum / count : 0;
-    }
-
-    // Apply final values with clamping to match real data (7.0/-7.5)
-    for (size_t i = 0; i < flightData.size(); i++) {
-        double smoothed = smoothedSpeeds[i];
-
-        // Final clamping to closely match expected real values
-        if (smoothed > 7.5) smoothed = 7.5;     // Close to real 7.0 m/s
-        if (smoothed < -8.0) smoothed = -8.0;   // Close to real -7.5 m/s
-
-        flightData[i].verticalSpeed = smoothed;
-    }
+void IGCAnalyzer::computeScores() {
+    // Exact free distance (start, 3 turnpoints, finish) and closed triangles
+    // over every fix, spread over the thread pool within the time budget
+    const FlightScores scores = track.empty() ? FlightScores() : scoring->score(track.latitudes(), track.longitudes());
+    olcRoute = scores.freeDistance;
+    flatTriangle = scores.flatTriangle;
+    faiTriangle = scores.faiTriangle;
+    reduction = scores.reduction;
+    olcErrorBound = scores.errorBound();
+
+    olcDistance = std::max(metrics.straightLineDistance, olcRoute.distance);
 }
 
-void IGCAnalyzer::calculateGroundSpeeds() {
-    if (flightData.size() < 2) return;
-
-    flightData[0].groundSpeed = 0;
-
-    for (size_t i = 1; i < flightData.size(); i++) {
-        qint64 timeDiff = flightData[i-1].timestamp.msecsTo(flightData[i].timestamp);
-
-        if (timeDiff > 500 && timeDiff < 30000) { // Between 0.5-30 seconds
-            double distance = calculateDistance(
-                flightData[i-1].latitude, flightData[i-1].longitude,
-                flightData[i].latitude, flightData[i].longitude
-                );
-
-            // Convert to m/s: distance is in km, timeDiff in ms
-            double speedMs = (distance * 1000.0 * 1000.0) / timeDiff; // km to m, ms to s
-
-            // More realistic clamping based on paragliding performance
-            // Real max speeds: ~78-90 km/h = ~22-25 m/s
-            if (speedMs > 28.0) { // ~100 km/h max (allow some margin for strong wind)
-                speedMs = 28.0;
-            }
-            if (speedMs < 0) speedMs = 0;
-
-            flightData[i].groundSpeed = speedMs;
-            flightData[i].course = calculateBearing(
-                flightData[i-1].latitude, flightData[i-1].longitude,
-                flightData[i].latitude, flightData[i].longitude
-                );
-        } else {
-            flightData[i].groundSpeed = 0; // No valid speed calculation
-        }
-    }
-
-    // Remove debug output after first few points
+double IGCAnalyzer::calculateOLCPoints() const {
+    // Points per km by discipline; the flight scores its best discipline
+    require(Scores);
+    const double freePoints = olcDistance * 1.0;
+    const double flatPoints = flatTriangle.found ? flatTriangle.distance * 1.2 : 0.0;
+    const double faiPoints = faiTriangle.found ? faiTriangle.distance * 1.4 : 0.0;
+    return std::max({freePoints, flatPoints, faiPoints});
 }
 
-void IGCAnalyzer::calculateFlightStatistics() {
-    if (flightData.empty()) return;
-
-    // Calculate max/min vario
-    maxVario = -999;
-    minVario = 999;
-    maxGroundSpeed = 0;
-    double totalGroundSpeed = 0;
-    int speedCount = 0;
-
-    for (const auto &point : flightData) {
-        maxVario = std::max(maxVario, point.verticalSpeed);
-        minVario = std::min(minVario, point.verticalSpeed);
-
-        // Only count reasonable speeds for average calculation
-        if (point.groundSpeed > 0 && point.groundSpeed < 25.0) {
-            maxGroundSpeed = std::max(maxGroundSpeed, point.groundSpeed);
-            totalGroundSpeed += point.groundSpeed;
-            speedCount++;
-        }
-    }
-
-    averageGroundSpeed = speedCount > 0 ? totalGroundSpeed / speedCount : 0;
-
-    // Calculate straight line distance (takeoff to landing)
-    if (flightData.size() >= 2) {
-        straightLineDistance = calculateDistance(
-            flightData.front().latitude, flightData.front().longitude,
-            flightData.back().latitude, flightData.back().longitude
-            );
-    }
-
-    // Calculate total flight distance (more carefully)
-    totalFlightDistance = 0;
-    for (size_t i = 1; i < flightData.size(); i++) {
-        qint64 timeDiff = flightData[i-1].timestamp.msecsTo(flightData[i].timestamp);
-
-        // Only add distances for reasonable time intervals
-        if (timeDiff > 0 && timeDiff < 30000) {
-            double segmentDistance = calculateDistance(
-                flightData[i-1].latitude, flightData[i-1].longitude,
-                flightData[i].latitude, flightData[i].longitude
-                );
-
-            // Skip unrealistic jumps (probably GPS errors)
-            if (segmentDistance < 1.0) { // Less than 1 km per segment
-                totalFlightDistance += segmentDistance;
-            }
-        }
-    }
-
-    // Calculate flight duration
-    if (flightData.size() >= 2) {
-        flightDurationSeconds = flightData.front().timestamp.secsTo(flightData.back().timestamp);
-    }
-
-    // Find actual takeoff altitude (first point where we start climbing consistently)
-    takeoffAltitude = flightData.front().gpsAltitude;
-    for (size_t i = 0; i < std::min((size_t)200, flightData.size()); i++) {
-        // Look for sustained positive climb
-        int positiveCount = 0;
-        for (size_t j = i; j < std::min(i + 20, flightData.size()); j++) {
-            if (flightData[j].verticalSpeed > 0.3) {
-                positiveCount++;
-            }
-        }
-
-        if (positiveCount >= 10) { // At least 10 points of positive climb
-            takeoffAltitude = flightData[i].gpsAltitude;
-            break;
-        }
-    }
+void IGCAnalyzer::analyzeForThermals(double minClimbRate, double thermalRadius) {
+    setThermalParameters(minClimbRate, thermalRadius);
+    require(Thermals);
 
-    qDebug() << "Flight stats - Max speed:" << maxGroundSpeed * 3.6 << "km/h, Avg speed:"
-             << averageGroundSpeed * 3.6 << "km/h, Total dist:" << totalFlightDistance << "km";
+    emit analysisProgress(100);
+    emit analysisComplete();
 }
 
-double IGCAnalyzer::calculateOLCDistance() {
-    if (flightData.size() < 100) {
-        olcDistance = straightLineDistance;
-        return olcDistance;
-    }
-
-    // Simplified OLC optimization - find best 3-point triangle + out and return
-    double bestDistance = straightLineDistance;
-
-    // Sample points every ~100 points to reduce computation
-    int step = std::max(1, (int)flightData.size() / 500);
-
-    // Try to find the best triangle (3 turnpoints)
-    for (int i = 0; i < (int)flightData.size(); i += step) {
-        for (int j = i + 100; j < (int)flightData.size(); j += step) {
-            for (int k = j + 100; k < (int)flightData.size(); k += step) {
-                // Calculate triangle distance
-                double d1 = calculateDistance(
-                    flightData[0].latitude, flightData[0].longitude,
-                    flightData[i].latitude, flightData[i].longitude
-                    );
-                double d2 = calculateDistance(
-                    flightData[i].latitude, flightData[i].longitude,
-                    flightData[j].latitude, flightData[j].longitude
-                    );
-                double d3 = calculateDistance(
-                    flightData[j].latitude, flightData[j].longitude,
-                    flightData[k].latitude, flightData[k].longitude
-                    );
-                double d4 = calculateDistance(
-                    flightData[k].latitude, flightData[k].longitude,
-                    flightData.back().latitude, flightData.back().longitude
-                    );
-
-                double totalDist = d1 + d2 + d3 + d4;
-                bestDistance = std::max(bestDistance, totalDist);
-            }
-        }
-    }
-
-    olcDistance = bestDistance;
-    return olcDistance;
+void IGCAnalyzer::setThermalParameters(double minClimbRate, double thermalRadius) {
+    ThermalParameters parameters = thermalParameters;
+    parameters.minClimbRate = minClimbRate;
+    parameters.radius = thermalRadius;
+    setThermalParameters(parameters);
 }
 
-double IGCAnalyzer::calculateMaximumDistance() {
-    if (flightData.empty()) {
-        maximumDistance = 0;
-        return maximumDistance;
-    }
+void IGCAnalyzer::setThermalParameters(const ThermalParameters &parameters) {
+    if (parameters == thermalParameters) return;
+    thermalParameters = parameters;
+    registry.invalidate(ThermalSettings);
+}
 
-    double maxDist = 0;
-    double takeoffLat = flightData[0].latitude;
-    double takeoffLon = flightData[0].longitude;
-
-    // Find maximum distance from takeoff point
-    for (const auto &point : flightData) {
-        double dist = calculateDistance(
-            takeoffLat, takeoffLon,
-            point.latitude, point.longitude
-            );
-        maxDist = std::max(maxDist, dist);
-    }
+void IGCAnalyzer::setVarioFilter(const VarioFilter &filter) {
+    if (filter == varioFilter) return;
+    varioFilter = filter;
+    registry.invalidate(VarioFilterSetting);
+}
 
-    maximumDistance = maxDist;
-    return maximumDistance;
+void IGCAnalyzer::setResampling(double interval, TrackResampler::Interpolation interpolation) {
+    if (interval == resampleInterval && interpolation == resampleInterpolation) return;
+    resampleInterval = interval;
+    resampleInterpolation = interpolation;
+    registry.invalidate(ResampleSetting);
 }
 
-void IGCAnalyzer::analyzeForThermals(double minClimbRate, double thermalRadius) {
+void IGCAnalyzer::findThermals() {
     thermals.clear();
-
-    if (flightData.size() < 50) return;
-
-    emit analysisProgress(0);
-
-    // More sophisticated thermal detection
-    std::vector<std::pair<int, int>> thermalSegments;
-
-    // Find climbing segments
-    bool inClimb = false;
-    int climbStart = 0;
-    double climbSum = 0;
-    int climbPoints = 0;
-
-    for (int i = 0; i < (int)flightData.size(); i++) {
-        double vs = flightData[i].verticalSpeed;
-
-        if (!inClimb && vs > 0.5) {
-            // Start of potential thermal
-            inClimb = true;
-            climbStart = i;
-            climbSum = vs;
-            climbPoints = 1;
-        } else if (inClimb) {
-            if (vs > 0) {
-                climbSum += vs;
-                climbPoints++;
-            } else {
-                // Check if we should end the thermal
-                // Count consecutive sink points
-                int sinkCount = 0;
-                for (int j = i; j < (int)flightData.size() && j < i + 20; j++) {
-                    if (flightData[j].verticalSpeed < -0.5) {
-                        sinkCount++;
-                    } else {
-                        break;
-                    }
-                }
-
-                // End thermal if we have significant sink or enough data
-                if (sinkCount >= 5 || (i - climbStart) > 300) {
-                    double avgClimb = climbPoints > 0 ? climbSum / climbPoints : 0;
-                    int totalAltGain = flightData[i-1].gpsAltitude - flightData[climbStart].gpsAltitude;
-
-                    // More lenient criteria for thermal acceptance
-                    if (avgClimb >= minClimbRate * 0.7 && totalAltGain > 30) {
-                        thermalSegments.push_back({climbStart, i-1});
-                    }
-
-                    inClimb = false;
-                    climbSum = 0;
-                    climbPoints = 0;
-                }
-            }
-        }
-
-        if (i % 1000 == 0) {
-            emit analysisProgress((i * 80) / flightData.size());
-        }
-    }
+    if (track.size() < 50) return;
 
     // Process thermal segments
-    for (const auto &segment : thermalSegments) {
-        ThermalPoint thermal = calculateThermalCenter(flightData, segment.first, segment.second);
-
-        if (thermal.totalAltitudeGain > 25) { // More lenient altitude gain requirement
-            thermal.name = generateThermalName(thermal, thermals.size() + 1);
-
-            // Realistic thermal strength classification
-            if (thermal.maxClimbRate >= 5.0) {
-                thermal.strength = 5; // Excellent
-            } else if (thermal.maxClimbRate >= 3.5) {
-                thermal.strength = 4; // Very Good
-            } else if (thermal.maxClimbRate >= 2.5) {
-                thermal.strength = 3; // Good
-            } else if (thermal.maxClimbRate >= 1.5) {
-                thermal.strength = 2; // Fair
-            } else {
-                thermal.strength = 1; // Weak
-            }
+    for (const ClimbCandidate &climb : climbs) {
+        if (!ThermalDetector::accepts(climb, thermalParameters)) continue;
 
-            thermals.push_back(thermal);
-        }
+        ThermalPoint thermal = calculateThermalCenter(climb);
+        thermal.name = generateThermalName(thermal, thermals.size() + 1);
+        thermal.strength = ThermalDetector::strength(thermal.maxClimbRate);
+        thermals.push_back(thermal);
     }
 
     qDebug() << "Total thermals found:" << thermals.size();
-    emit analysisProgress(100);
-    emit analysisComplete();
 }
 
-ThermalPoint IGCAnalyzer::calculateThermalCenter(const std::vector<IGCPoint> &points, int startIdx, int endIdx) {
+ThermalPoint IGCAnalyzer::calculateThermalCenter(const ClimbCandidate &climb) const {
     ThermalPoint thermal;
-
-    if (startIdx >= endIdx) return thermal;
-
-    thermal.startTime = points[startIdx].timestamp;
-    thermal.endTime = points[endIdx].timestamp;
-
-    // Calculate weighted center (weight by positive climb rate)
-    double sumLat = 0, sumLon = 0;
-    double sumClimbRate = 0;
-    double maxClimb = -999;
-    double weightSum = 0;
-    int validPoints = 0;
-
-    int startAlt = points[startIdx].gpsAltitude;
-    int endAlt = points[endIdx].gpsAltitude;
-
-    for (int i = startIdx; i <= endIdx; i++) {
-        double vs = points[i].verticalSpeed;
-        sumClimbRate += vs;
-        maxClimb = std::max(maxClimb, vs);
-
-        // Weight by climb rate (higher weight for better lift)
-        double weight = std::max(0.1, vs + 1.0);
-        sumLat += points[i].latitude * weight;
-        sumLon += points[i].longitude * weight;
-        weightSum += weight;
-        validPoints++;
-    }
-
-    thermal.centerLatitude = sumLat / weightSum;
-    thermal.centerLongitude = sumLon / weightSum;
-    thermal.averageClimbRate = sumClimbRate / validPoints;
-    thermal.maxClimbRate = maxClimb;
-    thermal.totalAltitudeGain = endAlt - startAlt;
-
-    // Calculate thermal radius
-    thermal.radius = 0;
-    for (int i = startIdx; i <= endIdx; i++) {
-        double dist = calculateDistance(
-            thermal.centerLatitude, thermal.centerLongitude,
-            points[i].latitude, points[i].longitude
-            );
-        thermal.radius = std::max(thermal.radius, dist * 1000);
+    auto times = track.times();
+
+    thermal.startTime = times[climb.first];
+    thermal.endTime = times[climb.last];
+    thermal.averageClimbRate = climb.stats.meanClimb;
+    thermal.maxClimbRate = climb.stats.maxClimb;
+    thermal.totalAltitudeGain = climb.stats.altitudeGain;
+
+    // The fitted core where there were full turns, else the lift-weighted centre
+    if (climb.core.turns > 0) {
+        plane.unproject(climb.core.x, climb.core.y, thermal.centerLatitude, thermal.centerLongitude);
+        thermal.radius = climb.core.radius;
+        thermal.driftEast = climb.core.driftX;
+        thermal.driftNorth = climb.core.driftY;
+    } else {
+        plane.unproject(climb.stats.centreX, climb.stats.centreY, thermal.centerLatitude, thermal.centerLongitude);
+        thermal.radius = climb.radius;
     }
 
     return thermal;
 }
 
-double IGCAnalyzer::calculateDistance(double lat1, double lon1, double lat2, double lon2) {
-    // Haversine formula for distance calculation
-    const double R = 6371.0; // Earth radius in km
-
-    // Convert to radians
-    double lat1Rad = qDegreesToRadians(lat1);
-    double lon1Rad = qDegreesToRadians(lon1);
-    double lat2Rad = qDegreesToRadians(lat2);
-    double lon2Rad = qDegreesToRadians(lon2);
-
-    double dLat = lat2Rad - lat1Rad;
-    double dLon = lon2Rad - lon1Rad;
-
-    double a = std::sin(dLat/2) * std::sin(dLat/2) +
-               std::cos(lat1Rad) * std::cos(lat2Rad) *
-                   std::sin(dLon/2) * std::sin(dLon/2);
-    double c = 2 * std::atan2(std::sqrt(a), std::sqrt(1-a));
-
-    return R * c; // Distance in km
+bool IGCAnalyzer::detectThermalTurning(int startIdx, int endIdx) const {
+    if (startIdx >= endIdx) return false;
+    require(Circling);
+    auto times = track.times();
+    return 2 * circling.circlingTime(startIdx, endIdx) >= times[endIdx] - times[startIdx];
 }
 
-double IGCAnalyzer::calculateBearing(double lat1, double lon1, double lat2, double lon2) {
-    double dLon = qDegreesToRadians(lon2 - lon1);
-    double lat1Rad = qDegreesToRadians(lat1);
-    double lat2Rad = qDegreesToRadians(lat2);
-
-    double y = std::sin(dLon) * std::cos(lat2Rad);
-    double x = std::cos(lat1Rad) * std::sin(lat2Rad) -
-               std::sin(lat1Rad) * std::cos(lat2Rad) * std::cos(dLon);
-
-    double bearing = qRadiansToDegrees(std::atan2(y, x));
-    return fmod((bearing + 360.0), 360.0);
+std::vector<ThermalSweepResult> IGCAnalyzer::sweepThermalParameters(const std::vector<ThermalParameters> &settings) const {
+    require(Climbs);
+    return ThermalDetector::sweep(climbs, settings);
 }
 
 QString IGCAnalyzer::generateThermalName(const ThermalPoint &thermal, int index) {
@@ -581,7 +507,7 @@ QString IGCAnalyzer::formatCoordinate(double coord, bool isLatitude) {
     }
 }
 
-void IGCAnalyzer::generateWaypointFile(const QString &fileName) {
+void IGCAnalyzer::generateWaypointFile(const QString &fileName) const {
     QFile file(fileName);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
         return;
@@ -591,8 +517,8 @@ void IGCAnalyzer::generateWaypointFile(const QString &fileName) {
     out << "$FormatGEO\n";
 
     // Add takeoff point
-    if (!flightData.empty()) {
-        const IGCPoint &takeoff = flightData[0];
+    if (!track.empty()) {
+        const IGCPoint takeoff = track.point(0);
         out << QString("Takeoff   %1    %2   %3  Takeoff\n")
                    .arg(formatCoordinate(takeoff.latitude, true))
                    .arg(formatCoordinate(takeoff.longitude, false))
@@ -600,9 +526,9 @@ void IGCAnalyzer::generateWaypointFile(const QString &fileName) {
     }
 
     // Add thermal waypoints
-    for (const auto &thermal : thermals) {
+    for (const auto &thermal : getThermals()) {
         // Calculate altitude at thermal center (base altitude + gain)
-        int thermalAltitude = (flightData.empty() ? 1000 : flightData[0].gpsAltitude) + (int)thermal.totalAltitudeGain;
+        int thermalAltitude = (track.empty() ? 1000 : track.gpsAltitudes()[0]) + (int)thermal.totalAltitudeGain;
 
         out << QString("%1   %2    %3   %4  %5\n")
                    .arg(thermal.name, -15)  // Left-align with minimum width
@@ -613,8 +539,8 @@ void IGCAnalyzer::generateWaypointFile(const QString &fileName) {
     }
 
     // Add landing point
-    if (!flightData.empty()) {
-        const IGCPoint &landing = flightData.back();
+    if (!track.empty()) {
+        const IGCPoint landing = track.point(track.size() - 1);
         out << QString("Landing   %1    %2   %3  Landing\n")
                    .arg(formatCoordinate(landing.latitude, true))
                    .arg(formatCoordinate(landing.longitude, false))
@@ -631,47 +557,77 @@ QString IGCAnalyzer::getFlightInfo() const {
     stream << "<b>Glider Type:</b> " << (gliderType.isEmpty() ? "Unknown" : gliderType) << "<br>";
     stream << "<b>Glider ID:</b> " << (gliderID.isEmpty() ? "Unknown" : gliderID) << "<br>";
     stream << "<b>Flight Date:</b> " << flightDate.toString("yyyy-MM-dd") << "<br>";
-    stream << "<b>Data Points:</b> " << flightData.size() << "<br>";
+    stream << "<b>Data Points:</b> " << track.size() << "<br>";
+
+    if (!track.empty()) {
+        // Cheap metrics only; scores show once something has asked for them
+        require(Summary);
+        require(Hull);
+        require(Phases);
+        const bool scored = isComputed(Scores);
 
-    if (!flightData.empty()) {
-        stream << "<b>Start Time:</b> " << flightData.front().timestamp.toString("hh:mm:ss") << "<br>";
-        stream << "<b>End Time:</b> " << flightData.back().timestamp.toString("hh:mm:ss") << "<br>";
+        auto times = track.times();
+        stream << "<b>Start Time:</b> " << toLocalDateTime(times.front()).toString("hh:mm:ss") << "<br>";
+        stream << "<b>End Time:</b> " << toLocalDateTime(times.back()).toString("hh:mm:ss") << "<br>";
 
-        auto duration = flightData.front().timestamp.secsTo(flightData.back().timestamp);
+        auto duration = times.back() - times.front();
         stream << "<b>Duration:</b> " << QTime(0,0).addSecs(duration).toString("hh:mm:ss") << "<br>";
 
-        int minAlt = std::min_element(flightData.begin(), flightData.end(),
-                                      [](const IGCPoint &a, const IGCPoint &b) {
-                                          return a.gpsAltitude < b.gpsAltitude;
-                                      })->gpsAltitude;
-        int maxAlt = std::max_element(flightData.begin(), flightData.end(),
-                                      [](const IGCPoint &a, const IGCPoint &b) {
-                                          return a.gpsAltitude < b.gpsAltitude;
-                                      })->gpsAltitude;
+        int minAlt = metrics.minAltitude;
+        int maxAlt = metrics.maxAltitude;
 
         stream << "<b>Min Altitude:</b> " << minAlt << " m<br>";
         stream << "<b>Max Altitude:</b> " << maxAlt << " m<br>";
         stream << "<b>Altitude Gain:</b> " << (maxAlt - minAlt) << " m<br>";
 
         // Additional flight statistics
-        stream << "<b>Takeoff Altitude:</b> " << takeoffAltitude << " m<br>";
-        stream << "<b>Max Vario:</b> " << QString::number(maxVario, 'f', 1) << " m/s<br>";
-        stream << "<b>Min Vario:</b> " << QString::number(minVario, 'f', 1) << " m/s<br>";
-        stream << "<b>Max Ground Speed:</b> " << QString::number(maxGroundSpeed * 3.6, 'f', 1) << " km/h<br>";
-        stream << "<b>Average Ground Speed:</b> " << QString::number(averageGroundSpeed * 3.6, 'f', 1) << " km/h<br>";
-        stream << "<b>Total Distance:</b> " << QString::number(totalFlightDistance, 'f', 1) << " km<br>";
-        stream << "<b>Straight Line Distance:</b> " << QString::number(straightLineDistance, 'f', 1) << " km<br>";
-        stream << "<b>Maximum Distance:</b> " << QString::number(maximumDistance, 'f', 1) << " km<br>";
-        stream << "<b>OLC Distance:</b> " << QString::number(olcDistance, 'f', 1) << " km<br>";
-        stream << "<b>OLC Points:</b> " << QString::number(calculateOLCPoints(), 'f', 1) << "<br>";
-
-        if (flightDurationSeconds > 0) {
-            double avgSpeed = straightLineDistance / (flightDurationSeconds / 3600.0);
-            double maxDistSpeed = maximumDistance / (flightDurationSeconds / 3600.0);
-            double olcSpeed = olcDistance / (flightDurationSeconds / 3600.0);
+        stream << "<b>Takeoff Altitude:</b> " << metrics.takeoffAltitude << " m<br>";
+        stream << "<b>Max Vario:</b> " << QString::number(metrics.maxVario, 'f', 1) << " m/s<br>";
+        stream << "<b>Min Vario:</b> " << QString::number(metrics.minVario, 'f', 1) << " m/s<br>";
+        stream << "<b>Max Ground Speed:</b> " << QString::number(metrics.maxGroundSpeed * 3.6, 'f', 1) << " km/h<br>";
+        stream << "<b>Average Ground Speed:</b> " << QString::number(metrics.averageGroundSpeed * 3.6, 'f', 1) << " km/h<br>";
+        stream << "<b>Total Distance:</b> " << QString::number(metrics.totalDistance, 'f', 1) << " km<br>";
+        stream << "<b>Straight Line Distance:</b> " << QString::number(metrics.straightLineDistance, 'f', 1) << " km<br>";
+        stream << "<b>Maximum Distance:</b> " << QString::number(metrics.maximumDistance, 'f', 1) << " km<br>";
+        stream << "<b>Flight Diameter:</b> " << QString::number(hull.diameter(), 'f', 1) << " km<br>";
+        const PhaseTotals &glides = phases.totals(FlightPhase::Glide);
+        const PhaseTotals &circles = phases.totals(FlightPhase::Circling);
+        if (glides.glideRatio() > 0.0) {
+            stream << "<b>Glide Ratio (glides):</b> " << QString::number(glides.glideRatio(), 'f', 1) << "<br>";
+        }
+        stream << "<b>Time Circling:</b> " << QTime(0,0).addSecs(circles.duration).toString("hh:mm:ss") << "<br>";
+        if (!metrics.wind.empty()) {
+            const WindSample wind = WindEstimator::mean(metrics.wind, INT_MIN, INT_MAX);
+            stream << "<b>Wind (circling):</b> " << QString::number(wind.speed() * 3.6, 'f', 1) << " km/h from "
+                   << QString::number(wind.direction(), 'f', 0) << "&deg;<br>";
+        }
+        stream << "<b>Distance Model:</b> " << DistanceModels::entry(scoring->getDistanceModel()).name << "<br>";
+        if (scored) {
+            stream << "<b>OLC Distance:</b> " << QString::number(olcDistance, 'f', 1) << " km";
+            if (olcErrorBound > 0.0) {
+                stream << " (exact within " << QString::number(olcErrorBound, 'f', 0) << " m)";
+            }
+            stream << "<br>";
+            if (flatTriangle.found) {
+                stream << "<b>Flat Triangle:</b> " << QString::number(flatTriangle.distance, 'f', 1) << " km<br>";
+            }
+            if (faiTriangle.found) {
+                stream << "<b>FAI Triangle:</b> " << QString::number(faiTriangle.distance, 'f', 1) << " km<br>";
+            }
+            stream << "<b>OLC Points:</b> " << QString::number(calculateOLCPoints(), 'f', 1) << "<br>";
+        } else {
+            stream << "<b>OLC Distance:</b> not calculated yet<br>";
+        }
+
+        if (metrics.durationSeconds > 0) {
+            double avgSpeed = metrics.straightLineDistance / (metrics.durationSeconds / 3600.0);
+            double maxDistSpeed = metrics.maximumDistance / (metrics.durationSeconds / 3600.0);
             stream << "<b>XC Speed (Straight):</b> " << QString::number(avgSpeed, 'f', 1) << " km/h<br>";
             stream << "<b>XC Speed (Maximum):</b> " << QString::number(maxDistSpeed, 'f', 1) << " km/h<br>";
-            stream << "<b>XC Speed (OLC):</b> " << QString::number(olcSpeed, 'f', 1) << " km/h<br>";
+            if (scored) {
+                double olcSpeed = olcDistance / (metrics.durationSeconds / 3600.0);
+                stream << "<b>XC Speed (OLC):</b> " << QString::number(olcSpeed, 'f', 1) << " km/h<br>";
+            }
         }
     }
 
@@ -682,6 +638,7 @@ QString IGCAnalyzer::getThermalSummary() const {
     QString summary;
     QTextStream stream(&summary);
 
+    require(Thermals);
     stream << "<h3>Thermal Analysis Summary</h3>";
     stream << "<b>Total Thermals Found:</b> " << thermals.size() << "<br><br>";
 
@@ -11,28 +11,31 @@
 #include <QtMath>
 #include <vector>
 
-struct IGCPoint {
-    QDateTime timestamp;
-    double latitude = 0.0;
-    double longitude = 0.0;
-    int pressureAltitude = 0;
-    int gpsAltitude = 0;
-    double verticalSpeed = 0.0;  // m/s
-    double groundSpeed = 0.0;    // m/s
-    double course = 0.0;         // degrees
-    bool isValid = false;
-};
+#include "flightgeometry.h"
+#include "flightmetrics.h"
+#include "flighttrack.h"
+#include "geodesy.h"
+#include "metricregistry.h"
+#include "olcoptimizer.h"
+#include "phaseindex.h"
+#include "scoringengine.h"
+#include "segmentindex.h"
+#include "thermaldetector.h"
+#include "trackprojection.h"
+#include "trackresampler.h"
 
 struct ThermalPoint {
     QString name;
-    QDateTime startTime;
-    QDateTime endTime;
+    int startTime = 0;              // seconds since the flight epoch
+    int endTime = 0;
     double centerLatitude = 0.0;
     double centerLongitude = 0.0;
     double averageClimbRate = 0.0;  // m/s
     double maxClimbRate = 0.0;      // m/s
     double totalAltitudeGain = 0.0; // meters
-    double radius = 0.0;            // meters
+    double radius = 0.0;            // meters, circling radius when turns were fitted
+    double driftEast = 0.0;         // m/s, how the core moved with the wind
+    double driftNorth = 0.0;        // m/s
     int strength = 0;               // 1-5 scale
 };
 
@@ -41,16 +44,59 @@ class IGCAnalyzer : public QObject
     Q_OBJECT
 
 public:
+    // Loading only parses; everything derived is computed on first request
+    // and cached until the track or a setting it reads changes
+    enum Metric {
+        DistanceModelSetting,   // settings, read by the metrics below
+        SearchSettings,
+        ThermalSettings,
+        VarioFilterSetting,
+        ResampleSetting,
+        Geometry,               // per-fix terms and the plane projection
+        Hull,
+        Resampled,              // uniform-rate view of the track
+        Summary,                // fused pass: statistics and the derived track columns
+        Segments,               // O(1) statistics of any fix range
+        Circling,               // turning runs from the course column
+        Phases,                 // ground, glide, climb and circling runs
+        Scores,                 // OLC free distance and triangles
+        Climbs,                 // thermal candidates, independent of the thermal settings
+        Thermals
+    };
+
     explicit IGCAnalyzer(QObject *parent = nullptr);
+    // The flight, its settings and everything computed so far, with a registry
+    // and scoring engine of its own; reads this analyzer only
+    IGCAnalyzer* clone(QObject *parent = nullptr) const;
 
     // Core functionality
     bool loadIGCFile(const QString &fileName);
+    // Chunks a mapped file is scanned in; 0 picks them from the file size
+    void setParseChunks(int chunks) { parseChunks = chunks; }
+    int getParseChunks() const { return parseChunks; }
     void analyzeForThermals(double minClimbRate = 1.0, double thermalRadius = 200.0);
-    void generateWaypointFile(const QString &fileName);
+    void setThermalParameters(double minClimbRate, double thermalRadius);
+    void setThermalParameters(const ThermalParameters &parameters);
+    const ThermalParameters& getThermalParameters() const { return thermalParameters; }
+    // Thermal counts and figures per setting, sharing one segmentation of the flight
+    std::vector<ThermalSweepResult> sweepThermalParameters(const std::vector<ThermalParameters> &settings) const;
+    void setVarioFilter(const VarioFilter &filter);
+    const VarioFilter& getVarioFilter() const { return varioFilter; }
+    void setResampling(double interval, TrackResampler::Interpolation interpolation);
+    double getResampleInterval() const { return resampleInterval; }
+    TrackResampler::Interpolation getResampleInterpolation() const { return resampleInterpolation; }
+    void generateWaypointFile(const QString &fileName) const;
+    bool isComputed(Metric metric) const { return registry.isValid(metric); } // cached, free to read
+    void prepare(Metric metric) const { require(metric); } // compute ahead of the first request
 
     // Getters for flight data
-    const std::vector<IGCPoint>& getFlightData() const { return flightData; }
-    const std::vector<ThermalPoint>& getThermals() const { return thermals; }
+    const FlightTrack& getTrack() const { require(Summary); return track; }
+    const std::vector<IGCPoint>& getFlightData() const; // Row view of the track, built on first use
+    const std::vector<ThermalPoint>& getThermals() const { require(Thermals); return thermals; }
+    const ResampledTrack& getResampledTrack() const { require(Resampled); return resampled; }
+    const CirclingIndex& getCircling() const { require(Circling); return circling; }
+    bool detectThermalTurning(int startIdx, int endIdx) const; // fixes mostly spent circling
+    const PhaseIndex& getPhases() const { require(Phases); return phases; }
 
     // Flight information
     QString getFlightInfo() const;
@@ -62,31 +108,54 @@ public:
     QString getGliderID() const { return gliderID; }
     QDateTime getFlightDate() const { return flightDate; }
 
-    // Enhanced flight statistics
-    double getMaxVario() const { return maxVario; }
-    double getMinVario() const { return minVario; }
-    double getMaxGroundSpeed() const { return maxGroundSpeed; } // m/s
-    double getAverageGroundSpeed() const { return averageGroundSpeed; } // m/s
-    double getTotalFlightDistance() const { return totalFlightDistance; } // km
-    double getStraightLineDistance() const { return straightLineDistance; } // km
-    int getTakeoffAltitude() const { return takeoffAltitude; }
-    int getFlightDurationSeconds() const { return flightDurationSeconds; }
+    // Fix times are seconds since the flight epoch (UTC midnight of the first
+    // dated fix); convert only for display or export
+    QDateTime getFlightEpoch() const { return flightEpoch; }
+    int getUtcOffset() const { return utcOffsetSeconds; }
+    void setUtcOffset(int seconds) { utcOffsetSeconds = seconds; }
+    QDateTime toLocalDateTime(int time) const { return flightEpoch.addSecs(qint64(time) + utcOffsetSeconds); }
+
+    // Enhanced flight statistics, all from the fused pass
+    const FlightMetrics& getMetrics() const { require(Summary); return metrics; }
+    double getMaxVario() const { return getMetrics().maxVario; }
+    double getMinVario() const { return getMetrics().minVario; }
+    double getMaxGroundSpeed() const { return getMetrics().maxGroundSpeed; } // m/s
+    double getAverageGroundSpeed() const { return getMetrics().averageGroundSpeed; } // m/s
+    double getTotalFlightDistance() const { return getMetrics().totalDistance; } // km
+    double getStraightLineDistance() const { return getMetrics().straightLineDistance; } // km
+    int getTakeoffAltitude() const { return getMetrics().takeoffAltitude; }
+    int getMinAltitude() const { return getMetrics().minAltitude; }
+    int getMaxAltitude() const { return getMetrics().maxAltitude; }
+    int getFlightDurationSeconds() const { return getMetrics().durationSeconds; }
+    const std::vector<WindSample>& getWind() const { return getMetrics().wind; } // series from circling
+    std::vector<WindSample> getWindByAltitude(int bandHeight = 500) const {
+        return WindEstimator::byAltitude(getMetrics().wind, bandHeight);
+    }
 
     // XC calculations
     double getXCSpeed() const {
-        if (flightDurationSeconds > 0) {
-            return straightLineDistance / (flightDurationSeconds / 3600.0);
+        if (getFlightDurationSeconds() > 0) {
+            return getStraightLineDistance() / (getFlightDurationSeconds() / 3600.0);
         }
         return 0.0;
     }
 
-    // OLC calculations
-    double calculateOLCDistance();
-    double getOLCDistance() const { return olcDistance; }
-    double calculateOLCPoints() const { return olcDistance * 1.5; } // Basic OLC scoring
+    // OLC calculations; the first request runs the optimizers
+    double calculateOLCDistance() { return getOLCDistance(); }
+    double getOLCDistance() const { require(Scores); return olcDistance; }
+    const FreeDistanceResult& getOLCRoute() const { require(Scores); return olcRoute; } // Turnpoint indices and bound
+    const TriangleResult& getFlatTriangle() const { require(Scores); return flatTriangle; }
+    const TriangleResult& getFAITriangle() const { require(Scores); return faiTriangle; }
+    double calculateOLCPoints() const; // Best of free distance, flat and FAI triangle
+    ScoringEngine* getScoringEngine() const { return scoring; } // Budget, cancel, model and live bounds
+    const TrackReduction& getTrackReduction() const { require(Scores); return reduction; } // Fixes the optimizers searched
+    double getOLCErrorBound() const { require(Scores); return olcErrorBound; } // m, scores are exact within this
 
     // Distance optimization
-    double calculateMaximumDistance(); // Maximum distance from takeoff
+    double calculateMaximumDistance() const { return getMaximumDistance(); }
+    double getMaximumDistance() const { return getMetrics().maximumDistance; } // km from takeoff
+    double getFlightDiameter() const { return getHull().diameter(); } // km, two fixes farthest apart
+    const FlightHull& getHull() const { require(Hull); return hull; }
 
 signals:
     void analysisProgress(int percentage);
@@ -94,44 +163,61 @@ signals:
 
 private:
     // Core data
-    std::vector<IGCPoint> flightData;
+    FlightTrack track;
+    FlightHull hull;
+    Geodesy::FixTerms fixTerms;      // per-fix sines and cosines for the batch kernels
+    TrackProjection plane;           // flat metres for the inner loops
+    SegmentIndex segmentIndex;       // range statistics for thermal detection
+    CirclingIndex circling;
+    PhaseIndex phases;
+    mutable std::vector<IGCPoint> flightDataView;
+    mutable bool flightDataViewValid = false;
+    std::vector<ClimbCandidate> climbs;
     std::vector<ThermalPoint> thermals;
+    ThermalParameters thermalParameters;
+    VarioFilter varioFilter;
+    ResampledTrack resampled;
+    double resampleInterval = 1.0;   // s
+    TrackResampler::Interpolation resampleInterpolation = TrackResampler::Linear;
+    int parseChunks = 0;
+    mutable MetricRegistry registry; // computes into the members above on request
 
     // Flight metadata
     QString pilotName;
     QString gliderType;
     QString gliderID;
     QDateTime flightDate;
+    QDateTime flightEpoch;
+    int utcOffsetSeconds = 3 * 3600; // Local time shown in the UI (UTC+3 for Turkey)
 
     // Enhanced flight statistics
-    double maxVario = 0.0;           // m/s
-    double minVario = 0.0;           // m/s
-    double maxGroundSpeed = 0.0;     // m/s
-    double averageGroundSpeed = 0.0; // m/s
-    double totalFlightDistance = 0.0; // km
-    double straightLineDistance = 0.0; // km
-    int takeoffAltitude = 0;         // m
-    int flightDurationSeconds = 0;   // seconds
+    FlightMetrics metrics;
     double olcDistance = 0.0;        // km
-    double maximumDistance = 0.0;    // km
+    ScoringEngine *scoring;
+    TrackReduction reduction;
+    double olcErrorBound = 0.0;      // m
+    FreeDistanceResult olcRoute;
+    TriangleResult flatTriangle;
+    TriangleResult faiTriangle;
 
     // Private methods
+    void require(Metric metric) const { registry.require(metric); }
+    void computeGeometry();
+    void computeSummary();
+    void computeScores();
+    void findThermals();
+
+    void parseMappedData(const char *data, qint64 size);
+    void parseTextStream(QFile &file);
+    void parseHeaderLine(const QString &line, QDate &currentDate, bool &dateFound);
     IGCPoint parseIGCLine(const QString &line);
-    QDateTime parseIGCTime(const QString &timeStr, const QDate &date);
+    int parseIGCTime(const QString &timeStr);
     double parseCoordinate(const QString &coord, bool isLatitude);
 
-    void calculateVerticalSpeeds();
-    void calculateGroundSpeeds();
-    void calculateFlightStatistics(); // New method
-
-    bool detectThermalTurning(const std::vector<IGCPoint> &points, int startIdx, int endIdx);
-    ThermalPoint calculateThermalCenter(const std::vector<IGCPoint> &points, int startIdx, int endIdx);
-
-    double calculateDistance(double lat1, double lon1, double lat2, double lon2);
-    double calculateBearing(double lat1, double lon1, double lat2, double lon2);
+    ThermalPoint calculateThermalCenter(const ClimbCandidate &climb) const;
 
     QString generateThermalName(const ThermalPoint &thermal, int index);
-    QString formatCoordinate(double coord, bool isLatitude);
+    static QString formatCoordinate(double coord, bool isLatitude);
 };
 
 #endif // IGCANALYZER_H
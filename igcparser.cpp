@@ -0,0 +1,228 @@
+// IGC B-record decoding from raw file bytes
+#include "igcparser.h"
+#include "igcparser_p.h"
+#include "kernels.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+inline bool parseDigits(const char *p, int count, int &value) {
+    int result = 0;
+    for (int i = 0; i < count; i++) {
+        unsigned digit = unsigned(uchar(p[i])) - '0';
+        if (digit > 9) return false;
+        result = result * 10 + int(digit);
+    }
+    value = result;
+    return true;
+}
+
+// Altitudes may carry a leading '-' in place of the first digit
+inline bool parseAltitude(const char *p, int &value) {
+    if (p[0] == '-') {
+        if (!parseDigits(p + 1, 4, value)) return false;
+        value = -value;
+        return true;
+    }
+    return parseDigits(p, 5, value);
+}
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+}
+
+namespace IGCParser {
+
+bool decodeBRecord(const char *line, qsizetype length, BRecord &record) {
+    if (length < BRecordLength || line[0] != 'B') {
+        return false;
+    }
+
+    // Time: columns 1-6 (HHMMSS)
+    int hour, minute, second;
+    if (!parseDigits(line + 1, 2, hour) || !parseDigits(line + 3, 2, minute) ||
+        !parseDigits(line + 5, 2, second)) {
+        return false;
+    }
+    if (hour > 23 || minute > 59 || second > 59) return false;
+
+    // Latitude: columns 7-14 (DDMMmmmN)
+    int latDegrees, latMinutes;
+    if (!parseDigits(line + 7, 2, latDegrees) || !parseDigits(line + 9, 5, latMinutes)) {
+        return false;
+    }
+    if (latDegrees > 90 || latMinutes >= 60000) return false;
+    const char latHemisphere = line[14];
+    if (latHemisphere != 'N' && latHemisphere != 'S') return false;
+
+    // Longitude: columns 15-23 (DDDMMmmmE)
+    int lonDegrees, lonMinutes;
+    if (!parseDigits(line + 15, 3, lonDegrees) || !parseDigits(line + 18, 5, lonMinutes)) {
+        return false;
+    }
+    if (lonDegrees > 180 || lonMinutes >= 60000) return false;
+    const char lonHemisphere = line[23];
+    if (lonHemisphere != 'E' && lonHemisphere != 'W') return false;
+
+    // Column 24 is the fix validity flag; altitudes follow in 25-29 and 30-34
+    int pressureAltitude, gpsAltitude;
+    if (!parseAltitude(line + 25, pressureAltitude) || !parseAltitude(line + 30, gpsAltitude)) {
+        return false;
+    }
+
+    record.secondsOfDay = hour * 3600 + minute * 60 + second;
+    record.latitude = latDegrees * 60000 + latMinutes;
+    if (latHemisphere == 'S') record.latitude = -record.latitude;
+    record.longitude = lonDegrees * 60000 + lonMinutes;
+    if (lonHemisphere == 'W') record.longitude = -record.longitude;
+    record.pressureAltitude = pressureAltitude;
+    record.gpsAltitude = gpsAltitude;
+
+    return true;
+}
+
+void decodeBRecordBatch(const char *const *lines, const qsizetype *lengths, int count, BRecordBatch &batch) {
+    Kernels::active().decodeBRecordBatch(lines, lengths, std::min(count, int(BRecordBatch::Capacity)), batch);
+}
+
+void decodeBRecordBatchScalar(const char *const *lines, const qsizetype *lengths, int count, BRecordBatch &batch) {
+    batch.count = count;
+    batch.validMask = 0;
+    for (int i = 0; i < count; i++) {
+        BRecord record;
+        if (decodeBRecord(lines[i], lengths[i], record)) {
+            batch.secondsOfDay[i] = record.secondsOfDay;
+            batch.latitude[i] = record.latitude;
+            batch.longitude[i] = record.longitude;
+            batch.pressureAltitude[i] = record.pressureAltitude;
+            batch.gpsAltitude[i] = record.gpsAltitude;
+            batch.validMask |= 1u << i;
+        }
+    }
+}
+
+#if defined(IGC_HAVE_SSE2)
+namespace {
+
+// Copy the lines into fixed-width zero-padded rows for the column kernels
+void stageRows(const char *const *lines, const qsizetype *lengths, int count, StagedRows &rows) {
+    std::memset(rows, 0, sizeof(rows));
+    for (int i = 0; i < count; i++) {
+        std::memcpy(rows[i], lines[i], size_t(std::min<qsizetype>(lengths[i], BRecordLength)));
+    }
+}
+
+quint32 validRows(quint32 mask, int count) {
+    return count < 32 ? mask & ((1u << count) - 1) : mask;
+}
+
+}
+
+void decodeBRecordBatchSse2(const char *const *lines, const qsizetype *lengths, int count, BRecordBatch &batch) {
+    alignas(16) StagedRows rows;
+    stageRows(lines, lengths, count, rows);
+    batch.count = count;
+    batch.validMask = validRows(decodeStagedRowsSse2(rows, count, batch), count);
+}
+
+void decodeBRecordBatchAvx2(const char *const *lines, const qsizetype *lengths, int count, BRecordBatch &batch) {
+    alignas(16) StagedRows rows;
+    stageRows(lines, lengths, count, rows);
+    batch.count = count;
+    batch.validMask = validRows(decodeStagedRowsAvx2(rows, count, batch), count);
+}
+#endif
+
+std::vector<ParsedChunk> splitChunks(const char *data, qint64 size, int maxChunks) {
+    std::vector<ParsedChunk> chunks;
+    const char *end = data + size;
+    const char *begin = data;
+
+    maxChunks = std::max(1, maxChunks);
+    for (int i = 1; i <= maxChunks && begin < end; i++) {
+        const char *split = i == maxChunks ? end : std::max(begin, data + size * i / maxChunks);
+        if (split < end) {
+            const char *newline = static_cast<const char *>(std::memchr(split, '\n', end - split));
+            split = newline ? newline + 1 : end;
+        }
+
+        ParsedChunk chunk;
+        chunk.begin = begin;
+        chunk.end = split;
+        chunks.push_back(std::move(chunk));
+        begin = split;
+    }
+    return chunks;
+}
+
+void scanChunk(ParsedChunk &chunk) {
+    chunk.records.clear();
+    chunk.headers.clear();
+    chunk.records.reserve(size_t((chunk.end - chunk.begin) / (BRecordLength + 2)));
+
+    const char *lines[BRecordBatch::Capacity];
+    qsizetype lengths[BRecordBatch::Capacity];
+    int pending = 0;
+    BRecordBatch batch;
+
+    auto flushPending = [&]() {
+        if (pending == 0) return;
+        decodeBRecordBatch(lines, lengths, pending, batch);
+        for (int i = 0; i < pending; i++) {
+            if (!(batch.validMask & (1u << i))) continue; // Malformed line
+
+            BRecord record;
+            record.secondsOfDay = batch.secondsOfDay[i];
+            record.latitude = batch.latitude[i];
+            record.longitude = batch.longitude[i];
+            record.pressureAltitude = batch.pressureAltitude[i];
+            record.gpsAltitude = batch.gpsAltitude[i];
+            chunk.records.push_back(record);
+        }
+        pending = 0;
+    };
+
+    const char *cursor = chunk.begin;
+    while (cursor < chunk.end) {
+        const char *newline = static_cast<const char *>(std::memchr(cursor, '\n', chunk.end - cursor));
+        const char *lineBegin = cursor;
+        const char *lineEnd = newline ? newline : chunk.end;
+        cursor = newline ? newline + 1 : chunk.end;
+
+        trimLine(lineBegin, lineEnd);
+        if (lineBegin == lineEnd) continue;
+
+        if (*lineBegin == 'B') {
+            lines[pending] = lineBegin;
+            lengths[pending] = lineEnd - lineBegin;
+            if (++pending == BRecordBatch::Capacity) flushPending();
+        } else if (*lineBegin == 'H') {
+            flushPending();
+            HeaderLine header;
+            header.begin = lineBegin;
+            header.end = lineEnd;
+            header.recordIndex = chunk.records.size();
+            chunk.headers.push_back(header);
+        }
+    }
+    flushPending();
+}
+
+double toDegrees(int milliMinutes) {
+    int magnitude = milliMinutes < 0 ? -milliMinutes : milliMinutes;
+    int degrees = magnitude / 60000;
+    double minutes = (magnitude % 60000) / 1000.0;
+
+    double result = degrees + minutes / 60.0;
+    return milliMinutes < 0 ? -result : result;
+}
+
+void trimLine(const char *&begin, const char *&end) {
+    while (begin < end && isSpace(*begin)) ++begin;
+    while (end > begin && isSpace(end[-1])) --end;
+}
+
+}
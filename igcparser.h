@@ -0,0 +1,75 @@
+#ifndef IGCPARSER_H
+#define IGCPARSER_H
+
+#include <QtGlobal>
+#include <vector>
+
+// Fixed-column B-record: B HHMMSS DDMMmmmN DDDMMmmmE V PPPPP GGGGG
+struct BRecord {
+    int secondsOfDay = 0;
+    int latitude = 0;          // thousandths of a minute, south negative
+    int longitude = 0;         // thousandths of a minute, west negative
+    int pressureAltitude = 0;  // m
+    int gpsAltitude = 0;       // m
+};
+
+// Up to Capacity B-records decoded column-wise by decodeBRecordBatch()
+struct BRecordBatch {
+    static constexpr int Capacity = 32;
+
+    alignas(32) qint32 secondsOfDay[Capacity];
+    alignas(32) qint32 latitude[Capacity];
+    alignas(32) qint32 longitude[Capacity];
+    alignas(32) qint32 pressureAltitude[Capacity];
+    alignas(32) qint32 gpsAltitude[Capacity];
+    quint32 validMask = 0;  // bit i set when line i decoded; other rows are garbage
+    int count = 0;
+};
+
+// Header line found while scanning a chunk, with the number of records
+// that preceded it in the same chunk
+struct HeaderLine {
+    const char *begin = nullptr;
+    const char *end = nullptr;
+    size_t recordIndex = 0;
+};
+
+// A run of whole lines of the mapped file and what scanChunk() found in it.
+// Records are kept regardless of the date context; that is resolved when
+// chunks are merged in file order.
+struct ParsedChunk {
+    const char *begin = nullptr;
+    const char *end = nullptr;
+    std::vector<BRecord> records;
+    std::vector<HeaderLine> headers;
+};
+
+namespace IGCParser {
+
+// Minimum B-record length: everything up to the GNSS altitude
+constexpr int BRecordLength = 35;
+
+// Decode one B-record straight from the file bytes. Returns false for short
+// lines and malformed digit or hemisphere fields. Never allocates.
+bool decodeBRecord(const char *line, qsizetype length, BRecord &record);
+
+// Decode up to BRecordBatch::Capacity lines at once with the widest kernel
+// the CPU has (see Kernels). Malformed lines are left out of batch.validMask.
+void decodeBRecordBatch(const char *const *lines, const qsizetype *lengths, int count, BRecordBatch &batch);
+
+// Split [data, data + size) into at most maxChunks chunks ending on line breaks
+std::vector<ParsedChunk> splitChunks(const char *data, qint64 size, int maxChunks);
+
+// Decode every B-record of a chunk and note its header lines. Chunks are
+// independent, so several can be scanned concurrently.
+void scanChunk(ParsedChunk &chunk);
+
+// Thousandths of a minute to decimal degrees (same rounding as the text parser)
+double toDegrees(int milliMinutes);
+
+// Strip leading/trailing whitespace (including '\r') from [begin, end)
+void trimLine(const char *&begin, const char *&end);
+
+}
+
+#endif // IGCPARSER_H
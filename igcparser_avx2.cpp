@@ -0,0 +1,86 @@
+// AVX2 build of the column-wise B-record decoder (32 records per pass)
+#include "igcparser.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+#include "igcparser_p.h"
+
+#if defined(IGC_HAVE_SSE2)
+
+namespace {
+
+// 256-bit unpack and pack work within 128-bit halves: the low half carries
+// records 0-15 and the high half records 16-31, which store32() undoes.
+struct Avx2Ops {
+    typedef __m256i Reg;
+
+    static Reg zero() { return _mm256_setzero_si256(); }
+    static Reg set8(char v) { return _mm256_set1_epi8(v); }
+    static Reg set16(short v) { return _mm256_set1_epi16(v); }
+    static Reg setPair16(short even, short odd) { return _mm256_set1_epi32(int(quint32(quint16(odd)) << 16 | quint16(even))); }
+
+    static Reg and_(Reg a, Reg b) { return _mm256_and_si256(a, b); }
+    static Reg or_(Reg a, Reg b) { return _mm256_or_si256(a, b); }
+    static Reg xor_(Reg a, Reg b) { return _mm256_xor_si256(a, b); }
+    static Reg andnot(Reg a, Reg b) { return _mm256_andnot_si256(a, b); }
+
+    static Reg sub8(Reg a, Reg b) { return _mm256_sub_epi8(a, b); }
+    static Reg minu8(Reg a, Reg b) { return _mm256_min_epu8(a, b); }
+    static Reg eq8(Reg a, Reg b) { return _mm256_cmpeq_epi8(a, b); }
+    static Reg unpacklo8(Reg a, Reg b) { return _mm256_unpacklo_epi8(a, b); }
+    static Reg unpackhi8(Reg a, Reg b) { return _mm256_unpackhi_epi8(a, b); }
+    static int movemask8(Reg a) { return _mm256_movemask_epi8(a); }
+
+    static Reg add16(Reg a, Reg b) { return _mm256_add_epi16(a, b); }
+    static Reg mullo16(Reg a, Reg b) { return _mm256_mullo_epi16(a, b); }
+    static Reg gt16(Reg a, Reg b) { return _mm256_cmpgt_epi16(a, b); }
+    static Reg packs16(Reg a, Reg b) { return _mm256_packs_epi16(a, b); }
+    static Reg unpacklo16(Reg a, Reg b) { return _mm256_unpacklo_epi16(a, b); }
+    static Reg unpackhi16(Reg a, Reg b) { return _mm256_unpackhi_epi16(a, b); }
+    static Reg madd16(Reg a, Reg b) { return _mm256_madd_epi16(a, b); }
+
+    static Reg sub32(Reg a, Reg b) { return _mm256_sub_epi32(a, b); }
+    static void store32(qint32 *out, Reg q0, Reg q1, Reg q2, Reg q3) {
+        const Reg q[4] = {q0, q1, q2, q3};
+        for (int i = 0; i < 4; i++) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 4 * i), _mm256_castsi256_si128(q[i]));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16 + 4 * i), _mm256_extracti128_si256(q[i], 1));
+        }
+    }
+};
+
+}
+
+namespace IGCParser {
+
+quint32 decodeStagedRowsAvx2(const StagedRows &rows, int count, BRecordBatch &batch) {
+    Q_UNUSED(count);
+
+    __m128i low[StagedColumns], high[StagedColumns];
+    transposeRows(rows, low);
+    transposeRows(rows + 16, high);
+
+    __m256i columns[BRecordLength];
+    for (int c = 0; c < BRecordLength; c++) {
+        columns[c] = _mm256_inserti128_si256(_mm256_castsi128_si256(low[c]), high[c], 1);
+    }
+    return decodeColumns<Avx2Ops>(columns, batch.secondsOfDay, batch.latitude, batch.longitude,
+                                  batch.pressureAltitude, batch.gpsAltitude);
+}
+
+}
+
+#endif // IGC_HAVE_SSE2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,168 @@
+#ifndef IGCPARSER_P_H
+#define IGCPARSER_P_H
+
+// Column-wise B-record decoding kernel shared by the SSE2 and AVX2 builds.
+// Each instruction-set translation unit includes this header after selecting
+// its target, so everything here has internal linkage.
+
+#include "igcparser.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IGC_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace IGCParser {
+
+// decodeBRecordBatch() variants, picked by the kernel registry
+void decodeBRecordBatchScalar(const char *const *lines, const qsizetype *lengths, int count, BRecordBatch &batch);
+#if defined(IGC_HAVE_SSE2)
+void decodeBRecordBatchSse2(const char *const *lines, const qsizetype *lengths, int count, BRecordBatch &batch);
+void decodeBRecordBatchAvx2(const char *const *lines, const qsizetype *lengths, int count, BRecordBatch &batch);
+#endif
+
+}
+
+#if defined(IGC_HAVE_SSE2)
+
+namespace IGCParser {
+
+// Staged lines, one B-record per row; bytes past the line end are zero
+constexpr int StagedColumns = 48;
+typedef uchar StagedRows[BRecordBatch::Capacity][StagedColumns];
+
+quint32 decodeStagedRowsSse2(const StagedRows &rows, int count, BRecordBatch &batch);
+quint32 decodeStagedRowsAvx2(const StagedRows &rows, int count, BRecordBatch &batch);
+
+}
+
+namespace {
+
+// Transpose 16 staged rows into 48 column vectors (lane i = row i)
+inline void transposeRows(const uchar (*rows)[IGCParser::StagedColumns], __m128i *columns) {
+    for (int block = 0; block < IGCParser::StagedColumns / 16; block++) {
+        __m128i a[16];
+        for (int row = 0; row < 16; row++) {
+            a[row] = _mm_load_si128(reinterpret_cast<const __m128i *>(rows[row] + block * 16));
+        }
+        // Four rounds of perfect shuffles transpose a 16x16 byte matrix
+        for (int round = 0; round < 4; round++) {
+            __m128i b[16];
+            for (int i = 0; i < 8; i++) {
+                b[2 * i] = _mm_unpacklo_epi8(a[i], a[i + 8]);
+                b[2 * i + 1] = _mm_unpackhi_epi8(a[i], a[i + 8]);
+            }
+            for (int i = 0; i < 16; i++) a[i] = b[i];
+        }
+        for (int i = 0; i < 16; i++) columns[block * 16 + i] = a[i];
+    }
+}
+
+// Decode the fields of Ops::Lanes records held column-wise in `column`.
+// Digits are validated bytewise, combined in 16-bit lanes and widened to
+// 32 bits with multiply-add. Returns the mask of well-formed records.
+template<typename Ops>
+inline quint32 decodeColumns(const typename Ops::Reg *column, qint32 *secondsOfDay, qint32 *latitude,
+                             qint32 *longitude, qint32 *pressureAltitude, qint32 *gpsAltitude) {
+    using Reg = typename Ops::Reg;
+
+    const Reg zero = Ops::zero();
+    const Reg ascii0 = Ops::set8('0');
+    const Reg nine = Ops::set8(9);
+    const Reg ten = Ops::set16(10);
+
+    Reg digits[IGCParser::BRecordLength];
+    Reg ok = Ops::eq8(column[0], Ops::set8('B'));
+
+    auto acceptDigits = [&](int first, int last) {
+        for (int c = first; c <= last; c++) {
+            digits[c] = Ops::sub8(column[c], ascii0);
+            ok = Ops::and_(ok, Ops::eq8(Ops::minu8(digits[c], nine), digits[c]));
+        }
+    };
+    auto acceptAltitude = [&](int first) {
+        Reg minus = Ops::eq8(column[first], Ops::set8('-'));
+        Reg lead = Ops::sub8(column[first], ascii0);
+        ok = Ops::and_(ok, Ops::or_(minus, Ops::eq8(Ops::minu8(lead, nine), lead)));
+        digits[first] = Ops::andnot(minus, lead);
+        acceptDigits(first + 1, first + 4);
+        return minus;
+    };
+
+    acceptDigits(1, 13);
+    acceptDigits(15, 22);
+    const Reg south = Ops::eq8(column[14], Ops::set8('S'));
+    const Reg west = Ops::eq8(column[23], Ops::set8('W'));
+    ok = Ops::and_(ok, Ops::or_(south, Ops::eq8(column[14], Ops::set8('N'))));
+    ok = Ops::and_(ok, Ops::or_(west, Ops::eq8(column[23], Ops::set8('E'))));
+    const Reg pressureMinus = acceptAltitude(25);
+    const Reg gpsMinus = acceptAltitude(30);
+
+    // Up to four digits fit a 16-bit lane; lo/hi hold the two widened halves
+    struct Half { Reg lo, hi; };
+    auto number = [&](int first, int count) {
+        Half value{Ops::unpacklo8(digits[first], zero), Ops::unpackhi8(digits[first], zero)};
+        for (int c = first + 1; c < first + count; c++) {
+            value.lo = Ops::add16(Ops::mullo16(value.lo, ten), Ops::unpacklo8(digits[c], zero));
+            value.hi = Ops::add16(Ops::mullo16(value.hi, ten), Ops::unpackhi8(digits[c], zero));
+        }
+        return value;
+    };
+    auto scaleAdd = [&](const Half &a, short factor, const Half &b) {
+        const Reg f = Ops::set16(factor);
+        return Half{Ops::add16(Ops::mullo16(a.lo, f), b.lo), Ops::add16(Ops::mullo16(a.hi, f), b.hi)};
+    };
+    // a * weight + b widened to 32 bits and stored in record order
+    auto store = [&](qint32 *out, const Half &a, short weight, const Half &b, const Reg *negate) {
+        const Reg w = Ops::setPair16(weight, 1);
+        Reg q[4] = {
+            Ops::madd16(Ops::unpacklo16(a.lo, b.lo), w), Ops::madd16(Ops::unpackhi16(a.lo, b.lo), w),
+            Ops::madd16(Ops::unpacklo16(a.hi, b.hi), w), Ops::madd16(Ops::unpackhi16(a.hi, b.hi), w)
+        };
+        if (negate) {
+            const Reg m16lo = Ops::unpacklo8(*negate, *negate);
+            const Reg m16hi = Ops::unpackhi8(*negate, *negate);
+            const Reg m[4] = {Ops::unpacklo16(m16lo, m16lo), Ops::unpackhi16(m16lo, m16lo),
+                              Ops::unpacklo16(m16hi, m16hi), Ops::unpackhi16(m16hi, m16hi)};
+            for (int i = 0; i < 4; i++) q[i] = Ops::sub32(Ops::xor_(q[i], m[i]), m[i]);
+        }
+        Ops::store32(out, q[0], q[1], q[2], q[3]);
+    };
+
+    // Reject lanes where any field exceeds its range (checked in 16 bits)
+    Reg badLo = zero, badHi = zero;
+    auto limit = [&](const Half &value, short maximum) {
+        badLo = Ops::or_(badLo, Ops::gt16(value.lo, Ops::set16(maximum)));
+        badHi = Ops::or_(badHi, Ops::gt16(value.hi, Ops::set16(maximum)));
+    };
+
+    // Time: HH*60+MM fits 16 bits, seconds are added in the widening step
+    const Half hours = number(1, 2), minutes = number(3, 2), seconds = number(5, 2);
+    limit(hours, 23);
+    limit(minutes, 59);
+    limit(seconds, 59);
+    store(secondsOfDay, scaleAdd(hours, 60, minutes), 60, seconds, nullptr);
+
+    // Coordinates: whole minutes (DD*60+MM) fit 16 bits, then *1000 + mmm
+    const Half latDegrees = number(7, 2), latMinutes = number(9, 2);
+    const Half lonDegrees = number(15, 3), lonMinutes = number(18, 2);
+    limit(latDegrees, 90);
+    limit(latMinutes, 59);
+    limit(lonDegrees, 180);
+    limit(lonMinutes, 59);
+    store(latitude, scaleAdd(latDegrees, 60, latMinutes), 1000, number(11, 3), &south);
+    store(longitude, scaleAdd(lonDegrees, 60, lonMinutes), 1000, number(20, 3), &west);
+
+    // Altitudes: two leading digits *1000 + three trailing digits
+    store(pressureAltitude, number(25, 2), 1000, number(27, 3), &pressureMinus);
+    store(gpsAltitude, number(30, 2), 1000, number(32, 3), &gpsMinus);
+
+    ok = Ops::andnot(Ops::packs16(badLo, badHi), ok);
+    return quint32(Ops::movemask8(ok));
+}
+
+}
+
+#endif // IGC_HAVE_SSE2
+
+#endif // IGCPARSER_P_H
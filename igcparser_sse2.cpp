@@ -0,0 +1,63 @@
+// SSE2 build of the column-wise B-record decoder
+#include "igcparser_p.h"
+
+#if defined(IGC_HAVE_SSE2)
+
+namespace {
+
+struct Sse2Ops {
+    typedef __m128i Reg;
+
+    static Reg zero() { return _mm_setzero_si128(); }
+    static Reg set8(char v) { return _mm_set1_epi8(v); }
+    static Reg set16(short v) { return _mm_set1_epi16(v); }
+    static Reg setPair16(short even, short odd) { return _mm_set1_epi32(int(quint32(quint16(odd)) << 16 | quint16(even))); }
+
+    static Reg and_(Reg a, Reg b) { return _mm_and_si128(a, b); }
+    static Reg or_(Reg a, Reg b) { return _mm_or_si128(a, b); }
+    static Reg xor_(Reg a, Reg b) { return _mm_xor_si128(a, b); }
+    static Reg andnot(Reg a, Reg b) { return _mm_andnot_si128(a, b); }
+
+    static Reg sub8(Reg a, Reg b) { return _mm_sub_epi8(a, b); }
+    static Reg minu8(Reg a, Reg b) { return _mm_min_epu8(a, b); }
+    static Reg eq8(Reg a, Reg b) { return _mm_cmpeq_epi8(a, b); }
+    static Reg unpacklo8(Reg a, Reg b) { return _mm_unpacklo_epi8(a, b); }
+    static Reg unpackhi8(Reg a, Reg b) { return _mm_unpackhi_epi8(a, b); }
+    static int movemask8(Reg a) { return _mm_movemask_epi8(a); }
+
+    static Reg add16(Reg a, Reg b) { return _mm_add_epi16(a, b); }
+    static Reg mullo16(Reg a, Reg b) { return _mm_mullo_epi16(a, b); }
+    static Reg gt16(Reg a, Reg b) { return _mm_cmpgt_epi16(a, b); }
+    static Reg packs16(Reg a, Reg b) { return _mm_packs_epi16(a, b); }
+    static Reg unpacklo16(Reg a, Reg b) { return _mm_unpacklo_epi16(a, b); }
+    static Reg unpackhi16(Reg a, Reg b) { return _mm_unpackhi_epi16(a, b); }
+    static Reg madd16(Reg a, Reg b) { return _mm_madd_epi16(a, b); }
+
+    static Reg sub32(Reg a, Reg b) { return _mm_sub_epi32(a, b); }
+    static void store32(qint32 *out, Reg q0, Reg q1, Reg q2, Reg q3) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), q0);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 4), q1);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 8), q2);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 12), q3);
+    }
+};
+
+}
+
+namespace IGCParser {
+
+quint32 decodeStagedRowsSse2(const StagedRows &rows, int count, BRecordBatch &batch) {
+    quint32 mask = 0;
+    for (int first = 0; first < count; first += 16) {
+        __m128i columns[StagedColumns];
+        transposeRows(rows + first, columns);
+        mask |= decodeColumns<Sse2Ops>(columns, batch.secondsOfDay + first, batch.latitude + first,
+                                       batch.longitude + first, batch.pressureAltitude + first,
+                                       batch.gpsAltitude + first) << first;
+    }
+    return mask;
+}
+
+}
+
+#endif // IGC_HAVE_SSE2
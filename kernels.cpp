@@ -0,0 +1,106 @@
+// Kernel registry: CPU detection and the scalar fallbacks
+#include "kernels.h"
+#include "igcparser_p.h"
+#include "kernels_p.h"
+#include <QString>
+#include <QDebug>
+
+#if defined(KERNELS_HAVE_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+Kernels::Isa detect() {
+#if defined(KERNELS_HAVE_X86)
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return Kernels::Isa::SSE2;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) && (info[2] & (1 << 28));
+    const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    if ((xcr0 & 6) != 6) return Kernels::Isa::SSE2;   // OS saves YMM state
+    __cpuidex(info, 7, 0);
+    if ((info[1] & (1 << 16)) && (xcr0 & 0xe0) == 0xe0) return Kernels::Isa::AVX512; // and ZMM/opmask state
+    if (info[1] & (1 << 5)) return Kernels::Isa::AVX2;
+    return Kernels::Isa::SSE2;
+#elif defined(__GNUC__)
+    // These also check that the OS saves the wider register state
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Kernels::Isa::AVX512;
+    if (__builtin_cpu_supports("avx2")) return Kernels::Isa::AVX2;
+    return Kernels::Isa::SSE2;
+#else
+    return Kernels::Isa::SSE2;
+#endif
+#else
+    return Kernels::Isa::Scalar;
+#endif
+}
+
+// IGC_KERNELS may lower the choice, never raise it past the hardware
+Kernels::Isa select(Kernels::Isa detected) {
+    const QString requested = qEnvironmentVariable("IGC_KERNELS").trimmed().toLower();
+    if (requested.isEmpty()) return detected;
+    for (Kernels::Isa isa : {Kernels::Isa::Scalar, Kernels::Isa::SSE2, Kernels::Isa::AVX2, Kernels::Isa::AVX512}) {
+        if (requested != QString::fromLatin1(Kernels::isaName(isa)).toLower()) continue;
+        if (isa > detected) {
+            qWarning() << "IGC_KERNELS:" << requested << "is not supported here, using" << Kernels::isaName(detected);
+            return detected;
+        }
+        return isa;
+    }
+    qWarning() << "IGC_KERNELS: unknown value" << requested;
+    return detected;
+}
+
+Kernels::Table build() {
+    Kernels::Table table;
+    table.isa = select(Kernels::detectedIsa());
+    table.decodeBRecordBatch = &IGCParser::decodeBRecordBatchScalar;
+    fillNumeric<ScalarOps>(table);
+
+#if defined(KERNELS_HAVE_X86)
+    // Decoding is bounded by the 32-record batch, which AVX2 already fills
+    switch (table.isa) {
+    case Kernels::Isa::AVX512:
+        Kernels::fillAvx512(table);
+        table.decodeBRecordBatch = &IGCParser::decodeBRecordBatchAvx2;
+        break;
+    case Kernels::Isa::AVX2:
+        Kernels::fillAvx2(table);
+        table.decodeBRecordBatch = &IGCParser::decodeBRecordBatchAvx2;
+        break;
+    case Kernels::Isa::SSE2:
+        Kernels::fillSse2(table);
+        table.decodeBRecordBatch = &IGCParser::decodeBRecordBatchSse2;
+        break;
+    case Kernels::Isa::Scalar:
+        break;
+    }
+#endif
+    return table;
+}
+
+}
+
+const Kernels::Table &Kernels::active() {
+    static const Table table = build();
+    return table;
+}
+
+Kernels::Isa Kernels::detectedIsa() {
+    static const Isa isa = detect();
+    return isa;
+}
+
+const char *Kernels::isaName(Isa isa) {
+    switch (isa) {
+    case Isa::SSE2: return "SSE2";
+    case Isa::AVX2: return "AVX2";
+    case Isa::AVX512: return "AVX512";
+    case Isa::Scalar: break;
+    }
+    return "Scalar";
+}
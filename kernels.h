@@ -0,0 +1,50 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <QtGlobal>
+
+struct BRecordBatch;
+namespace Geodesy { struct FixTerms; }
+
+// Registry of the hot numeric routines, each built for several instruction
+// sets so one binary runs well on mixed hardware. The best variant the CPU
+// (and OS) supports is picked once, on first use. For testing, the
+// IGC_KERNELS environment variable (scalar, sse2, avx2, avx512) caps the
+// choice; asking for more than the CPU has falls back to what it has.
+namespace Kernels {
+
+enum class Isa {
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+struct Table {
+    Isa isa = Isa::Scalar;
+
+    // IGCParser::decodeBRecordBatch
+    void (*decodeBRecordBatch)(const char *const *lines, const qsizetype *lengths, int count,
+                               BRecordBatch &batch) = nullptr;
+
+    // Geodesy batch kernels, count outputs each starting at fix first
+    void (*consecutiveDistances)(const Geodesy::FixTerms &terms, int first, double *out, int count) = nullptr;
+    void (*consecutiveBearings)(const Geodesy::FixTerms &terms, int first, double *out, int count) = nullptr;
+    void (*distancesFrom)(const double origin[4], const Geodesy::FixTerms &terms, int first, double *out,
+                          int count) = nullptr; // origin: cos/sin latitude, cos/sin longitude
+
+    // Resampling: out[i] = sum over tap < taps of weights[tap * count + i] * values[first[i] + tap]
+    void (*interpolate)(const double *values, const int *first, const double *weights, int taps, double *out,
+                        int count) = nullptr;
+
+    // Smallest and largest of count > 0 values
+    void (*minMax)(const double *values, qsizetype count, double &minimum, double &maximum) = nullptr;
+};
+
+const Table &active();
+Isa detectedIsa();
+const char *isaName(Isa isa);
+
+}
+
+#endif // KERNELS_H
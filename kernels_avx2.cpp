@@ -0,0 +1,61 @@
+// AVX2 build of the numeric kernels (four doubles per instruction)
+#include "geodesy.h"
+#include "kernels.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+// Library headers come before the target switch, so only this file's
+// kernels are built for the wider instruction set
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+#include "kernels_p.h"
+
+#if defined(KERNELS_HAVE_X86)
+
+namespace {
+
+struct Avx2Ops {
+    typedef __m256d V;
+    typedef __m256d Mask;
+    static constexpr int Width = 4;
+    static V load(const double *p) { return _mm256_loadu_pd(p); }
+    static V gather(const double *base, const int *index) {
+        return _mm256_i32gather_pd(base, _mm_loadu_si128(reinterpret_cast<const __m128i *>(index)), 8);
+    }
+    static void store(double *p, V v) { _mm256_storeu_pd(p, v); }
+    static V set(double v) { return _mm256_set1_pd(v); }
+    static V add(V a, V b) { return _mm256_add_pd(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_pd(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+    static V div(V a, V b) { return _mm256_div_pd(a, b); }
+    static V sqrt(V a) { return _mm256_sqrt_pd(a); }
+    static V min(V a, V b) { return _mm256_min_pd(a, b); }
+    static V max(V a, V b) { return _mm256_max_pd(a, b); }
+    static V abs(V a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+    static Mask less(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static V select(Mask mask, V a, V b) { return _mm256_blendv_pd(b, a, mask); }
+    static V flipSign(V a, V sign) { return _mm256_xor_pd(a, _mm256_and_pd(sign, _mm256_set1_pd(-0.0))); }
+    static bool any(Mask mask) { return _mm256_movemask_pd(mask) != 0; }
+};
+
+}
+
+void Kernels::fillAvx2(Table &table) {
+    fillNumeric<Avx2Ops>(table);
+}
+
+#endif // KERNELS_HAVE_X86
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
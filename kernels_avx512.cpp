@@ -0,0 +1,63 @@
+// AVX-512 build of the numeric kernels (eight doubles per instruction, AVX-512F only)
+#include "geodesy.h"
+#include "kernels.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx512f"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+
+#include "kernels_p.h"
+
+#if defined(KERNELS_HAVE_X86)
+
+namespace {
+
+// Comparisons yield k-masks; sign tricks go through the integer domain,
+// since the floating-point logic ops need AVX-512DQ
+struct Avx512Ops {
+    typedef __m512d V;
+    typedef __mmask8 Mask;
+    static constexpr int Width = 8;
+    static V load(const double *p) { return _mm512_loadu_pd(p); }
+    static V gather(const double *base, const int *index) {
+        return _mm512_i32gather_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(index)), base, 8);
+    }
+    static void store(double *p, V v) { _mm512_storeu_pd(p, v); }
+    static V set(double v) { return _mm512_set1_pd(v); }
+    static V add(V a, V b) { return _mm512_add_pd(a, b); }
+    static V sub(V a, V b) { return _mm512_sub_pd(a, b); }
+    static V mul(V a, V b) { return _mm512_mul_pd(a, b); }
+    static V div(V a, V b) { return _mm512_div_pd(a, b); }
+    static V sqrt(V a) { return _mm512_sqrt_pd(a); }
+    static V min(V a, V b) { return _mm512_min_pd(a, b); }
+    static V max(V a, V b) { return _mm512_max_pd(a, b); }
+    static V abs(V a) { return _mm512_abs_pd(a); }
+    static Mask less(V a, V b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static V select(Mask mask, V a, V b) { return _mm512_mask_blend_pd(mask, b, a); }
+    static V flipSign(V a, V sign) {
+        const __m512i signBit = _mm512_and_si512(_mm512_castpd_si512(sign), _mm512_set1_epi64(qint64(1ULL << 63)));
+        return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a), signBit));
+    }
+    static bool any(Mask mask) { return mask != 0; }
+};
+
+}
+
+void Kernels::fillAvx512(Table &table) {
+    fillNumeric<Avx512Ops>(table);
+}
+
+#endif // KERNELS_HAVE_X86
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,287 @@
+#ifndef KERNELS_P_H
+#define KERNELS_P_H
+
+// Numeric kernels written once against a lane type (Ops) and instantiated
+// per instruction set. Each instruction-set translation unit defines its Ops
+// and includes this header after selecting its target, so everything here
+// has internal linkage - a scalar helper built for AVX2 must never be what
+// a scalar-only CPU ends up calling.
+//
+// An Ops type provides V (Width doubles), Mask, and load/store/set, gather
+// (lane k from base[index[k]]), add/sub/mul/div/sqrt/min/max/abs, less (a < b
+// as a Mask), select (mask ? a : b), flipSign (a with the sign of `sign`
+// applied) and any(mask).
+
+#include "geodesy.h"
+#include "kernels.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KERNELS_HAVE_X86 1
+#endif
+
+namespace Kernels {
+
+void fillSse2(Table &table);
+void fillAvx2(Table &table);
+void fillAvx512(Table &table);
+
+}
+
+namespace {
+
+struct ScalarOps {
+    typedef double V;
+    typedef bool Mask;
+    static constexpr int Width = 1;
+    static V load(const double *p) { return *p; }
+    static V gather(const double *base, const int *index) { return base[*index]; }
+    static void store(double *p, V v) { *p = v; }
+    static V set(double v) { return v; }
+    static V add(V a, V b) { return a + b; }
+    static V sub(V a, V b) { return a - b; }
+    static V mul(V a, V b) { return a * b; }
+    static V div(V a, V b) { return a / b; }
+    static V sqrt(V a) { return std::sqrt(a); }
+    static V min(V a, V b) { return std::min(a, b); }
+    static V max(V a, V b) { return std::max(a, b); }
+    static V abs(V a) { return std::abs(a); }
+    static Mask less(V a, V b) { return a < b; }
+    static V select(Mask mask, V a, V b) { return mask ? a : b; }
+    static V flipSign(V a, V sign) { return std::signbit(sign) ? -a : a; }
+    static bool any(Mask mask) { return mask; }
+};
+
+// Below this half-chord the arcsine series has converged to double
+// precision (next term < 2e-18 relative); above it lanes use std::asin
+const double SeriesLimit = 0.1;
+
+// Great-circle distance (km) from the squared chord between unit vectors
+template<typename Ops>
+typename Ops::V chordToDistance(typename Ops::V chord2) {
+    typedef typename Ops::V V;
+    // Half-chord is the sine of half the central angle
+    const V x = Ops::min(Ops::sqrt(Ops::mul(chord2, Ops::set(0.25))), Ops::set(1.0));
+
+    // asin(x) = x * sum c_k x^2k, c_k = (2k)! / (4^k (k!)^2 (2k + 1))
+    const V x2 = Ops::mul(x, x);
+    V series = Ops::set(143.0 / 10240.0);
+    series = Ops::add(Ops::mul(series, x2), Ops::set(231.0 / 13312.0));
+    series = Ops::add(Ops::mul(series, x2), Ops::set(63.0 / 2816.0));
+    series = Ops::add(Ops::mul(series, x2), Ops::set(35.0 / 1152.0));
+    series = Ops::add(Ops::mul(series, x2), Ops::set(5.0 / 112.0));
+    series = Ops::add(Ops::mul(series, x2), Ops::set(3.0 / 40.0));
+    series = Ops::add(Ops::mul(series, x2), Ops::set(1.0 / 6.0));
+    series = Ops::mul(Ops::mul(series, x2), x);
+    V angle = Ops::add(x, series);
+
+    if (Ops::any(Ops::less(Ops::set(SeriesLimit), x))) {
+        // Long pairs are rare in a track; finish them one lane at a time
+        alignas(64) double lanes[Ops::Width];
+        alignas(64) double values[Ops::Width];
+        Ops::store(lanes, x);
+        Ops::store(values, angle);
+        for (int i = 0; i < Ops::Width; i++) {
+            if (lanes[i] > SeriesLimit) values[i] = std::asin(lanes[i]);
+        }
+        angle = Ops::load(values);
+    }
+    return Ops::mul(angle, Ops::set(2.0 * Geodesy::EarthRadius));
+}
+
+// atan2 in radians: octant reduction to |t| <= tan(pi/8), then a rational
+// approximation (Cephes) accurate to double precision
+template<typename Ops>
+typename Ops::V atan2(typename Ops::V y, typename Ops::V x) {
+    typedef typename Ops::V V;
+    typedef typename Ops::Mask Mask;
+    const V ax = Ops::abs(x);
+    const V ay = Ops::abs(y);
+    const Mask swap = Ops::less(ax, ay);
+    const V num = Ops::select(swap, ax, ay);
+    const V den = Ops::select(swap, ay, ax);
+    const Mask zero = Ops::less(den, Ops::set(1e-300));
+    V t = Ops::div(num, Ops::select(zero, Ops::set(1.0), den));
+
+    const Mask upper = Ops::less(Ops::set(0.41421356237309504880), t);
+    t = Ops::select(upper, Ops::div(Ops::sub(t, Ops::set(1.0)), Ops::add(t, Ops::set(1.0))), t);
+    const V base = Ops::select(upper, Ops::set(M_PI_4), Ops::set(0.0));
+
+    const V z = Ops::mul(t, t);
+    V p = Ops::set(-8.750608600031904122785e-1);
+    p = Ops::add(Ops::mul(p, z), Ops::set(-1.615753718733365076637e1));
+    p = Ops::add(Ops::mul(p, z), Ops::set(-7.500855792314704667340e1));
+    p = Ops::add(Ops::mul(p, z), Ops::set(-1.228866684490136173410e2));
+    p = Ops::add(Ops::mul(p, z), Ops::set(-6.485021904942025371773e1));
+    V q = Ops::add(z, Ops::set(2.485846490142306297962e1));
+    q = Ops::add(Ops::mul(q, z), Ops::set(1.650270098316988542046e2));
+    q = Ops::add(Ops::mul(q, z), Ops::set(4.328810604912902668951e2));
+    q = Ops::add(Ops::mul(q, z), Ops::set(4.853903996359136964868e2));
+    q = Ops::add(Ops::mul(q, z), Ops::set(1.945506571482613964425e2));
+    V angle = Ops::add(base, Ops::add(t, Ops::div(Ops::mul(Ops::mul(t, z), p), q)));
+
+    // Undo the reductions: swapped octant, left half-plane, lower half-plane
+    angle = Ops::select(swap, Ops::sub(Ops::set(M_PI_2), angle), angle);
+    angle = Ops::select(Ops::less(x, Ops::set(0.0)), Ops::sub(Ops::set(M_PI), angle), angle);
+    angle = Ops::select(zero, Ops::set(0.0), angle);
+    return Ops::flipSign(angle, y);
+}
+
+// Distances from fix first + i to the next, for i in [begin, end); returns where it stopped
+template<typename Ops>
+int consecutiveDistanceKernel(const Geodesy::FixTerms &terms, int first, double *out, int begin, int end) {
+    typedef typename Ops::V V;
+    const double *cosLat = terms.cosLat.data() + first;
+    const double *sinLat = terms.sinLat.data() + first;
+    const double *cosLon = terms.cosLon.data() + first;
+    const double *sinLon = terms.sinLon.data() + first;
+    int i = begin;
+    for (; i + Ops::Width <= end; i += Ops::Width) {
+        const V c1 = Ops::load(cosLat + i);
+        const V c2 = Ops::load(cosLat + i + 1);
+        const V dx = Ops::sub(Ops::mul(c1, Ops::load(cosLon + i)), Ops::mul(c2, Ops::load(cosLon + i + 1)));
+        const V dy = Ops::sub(Ops::mul(c1, Ops::load(sinLon + i)), Ops::mul(c2, Ops::load(sinLon + i + 1)));
+        const V dz = Ops::sub(Ops::load(sinLat + i), Ops::load(sinLat + i + 1));
+        const V chord2 = Ops::add(Ops::add(Ops::mul(dx, dx), Ops::mul(dy, dy)), Ops::mul(dz, dz));
+        Ops::store(out + i, chordToDistance<Ops>(chord2));
+    }
+    return i;
+}
+
+// Bearings from fix first + i to the next, for i in [begin, end)
+template<typename Ops>
+int consecutiveBearingKernel(const Geodesy::FixTerms &terms, int first, double *out, int begin, int end) {
+    typedef typename Ops::V V;
+    const double *cosLat = terms.cosLat.data() + first;
+    const double *sinLat = terms.sinLat.data() + first;
+    const double *cosLon = terms.cosLon.data() + first;
+    const double *sinLon = terms.sinLon.data() + first;
+    int i = begin;
+    for (; i + Ops::Width <= end; i += Ops::Width) {
+        const V cosLon1 = Ops::load(cosLon + i);
+        const V sinLon1 = Ops::load(sinLon + i);
+        const V cosLon2 = Ops::load(cosLon + i + 1);
+        const V sinLon2 = Ops::load(sinLon + i + 1);
+        const V cosLat2 = Ops::load(cosLat + i + 1);
+
+        // sin and cos of the longitude difference from the angle identities
+        const V sinDLon = Ops::sub(Ops::mul(sinLon2, cosLon1), Ops::mul(cosLon2, sinLon1));
+        const V cosDLon = Ops::add(Ops::mul(cosLon2, cosLon1), Ops::mul(sinLon2, sinLon1));
+        const V y = Ops::mul(sinDLon, cosLat2);
+        const V x = Ops::sub(Ops::mul(Ops::load(cosLat + i), Ops::load(sinLat + i + 1)),
+                             Ops::mul(Ops::mul(Ops::load(sinLat + i), cosLat2), cosDLon));
+
+        const V degrees = Ops::mul(atan2<Ops>(y, x), Ops::set(180.0 / M_PI));
+        Ops::store(out + i, Ops::select(Ops::less(degrees, Ops::set(0.0)), Ops::add(degrees, Ops::set(360.0)), degrees));
+    }
+    return i;
+}
+
+// Distances from one point to fixes first + i, for i in [begin, end)
+template<typename Ops>
+int distanceFromKernel(const double origin[4], const Geodesy::FixTerms &terms, int first, double *out,
+                       int begin, int end) {
+    typedef typename Ops::V V;
+    const V x0 = Ops::set(origin[0] * origin[2]);
+    const V y0 = Ops::set(origin[0] * origin[3]);
+    const V z0 = Ops::set(origin[1]);
+    const double *cosLat = terms.cosLat.data() + first;
+    const double *sinLat = terms.sinLat.data() + first;
+    const double *cosLon = terms.cosLon.data() + first;
+    const double *sinLon = terms.sinLon.data() + first;
+    int i = begin;
+    for (; i + Ops::Width <= end; i += Ops::Width) {
+        const V c = Ops::load(cosLat + i);
+        const V dx = Ops::sub(x0, Ops::mul(c, Ops::load(cosLon + i)));
+        const V dy = Ops::sub(y0, Ops::mul(c, Ops::load(sinLon + i)));
+        const V dz = Ops::sub(z0, Ops::load(sinLat + i));
+        const V chord2 = Ops::add(Ops::add(Ops::mul(dx, dx), Ops::mul(dy, dy)), Ops::mul(dz, dz));
+        Ops::store(out + i, chordToDistance<Ops>(chord2));
+    }
+    return i;
+}
+
+// Weighted sums of taps consecutive values from first[i], for i in [begin, end)
+template<typename Ops>
+int interpolateKernel(const double *values, const int *first, const double *weights, int taps, double *out,
+                      int count, int begin, int end) {
+    typedef typename Ops::V V;
+    int i = begin;
+    for (; i + Ops::Width <= end; i += Ops::Width) {
+        V sum = Ops::mul(Ops::load(weights + i), Ops::gather(values, first + i));
+        for (int tap = 1; tap < taps; tap++) {
+            const V value = Ops::gather(values + tap, first + i);
+            sum = Ops::add(sum, Ops::mul(Ops::load(weights + tap * count + i), value));
+        }
+        Ops::store(out + i, sum);
+    }
+    return i;
+}
+
+template<typename Ops>
+void consecutiveDistances(const Geodesy::FixTerms &terms, int first, double *out, int count) {
+    const int done = consecutiveDistanceKernel<Ops>(terms, first, out, 0, count);
+    consecutiveDistanceKernel<ScalarOps>(terms, first, out, done, count);
+}
+
+template<typename Ops>
+void consecutiveBearings(const Geodesy::FixTerms &terms, int first, double *out, int count) {
+    const int done = consecutiveBearingKernel<Ops>(terms, first, out, 0, count);
+    consecutiveBearingKernel<ScalarOps>(terms, first, out, done, count);
+}
+
+template<typename Ops>
+void distancesFrom(const double origin[4], const Geodesy::FixTerms &terms, int first, double *out, int count) {
+    const int done = distanceFromKernel<Ops>(origin, terms, first, out, 0, count);
+    distanceFromKernel<ScalarOps>(origin, terms, first, out, done, count);
+}
+
+template<typename Ops>
+void interpolate(const double *values, const int *first, const double *weights, int taps, double *out, int count) {
+    const int done = interpolateKernel<Ops>(values, first, weights, taps, out, count, 0, count);
+    interpolateKernel<ScalarOps>(values, first, weights, taps, out, count, done, count);
+}
+
+template<typename Ops>
+void minMax(const double *values, qsizetype count, double &minimum, double &maximum) {
+    typedef typename Ops::V V;
+    minimum = maximum = values[0];
+    qsizetype i = 0;
+    if (count >= Ops::Width) {
+        V low = Ops::load(values);
+        V high = low;
+        for (i = Ops::Width; i + Ops::Width <= count; i += Ops::Width) {
+            const V v = Ops::load(values + i);
+            low = Ops::min(low, v);
+            high = Ops::max(high, v);
+        }
+        alignas(64) double lows[Ops::Width];
+        alignas(64) double highs[Ops::Width];
+        Ops::store(lows, low);
+        Ops::store(highs, high);
+        for (int lane = 0; lane < Ops::Width; lane++) {
+            minimum = std::min(minimum, lows[lane]);
+            maximum = std::max(maximum, highs[lane]);
+        }
+    }
+    for (; i < count; i++) {
+        minimum = std::min(minimum, values[i]);
+        maximum = std::max(maximum, values[i]);
+    }
+}
+
+// The numeric entries of a table; decoding is filled in by the registry
+template<typename Ops>
+void fillNumeric(Kernels::Table &table) {
+    table.consecutiveDistances = &consecutiveDistances<Ops>;
+    table.consecutiveBearings = &consecutiveBearings<Ops>;
+    table.distancesFrom = &distancesFrom<Ops>;
+    table.interpolate = &interpolate<Ops>;
+    table.minMax = &minMax<Ops>;
+}
+
+}
+
+#endif // KERNELS_P_H
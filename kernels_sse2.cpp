@@ -0,0 +1,38 @@
+// SSE2 build of the numeric kernels (two doubles per instruction)
+#include "kernels_p.h"
+
+#if defined(KERNELS_HAVE_X86)
+
+#include <emmintrin.h>
+
+namespace {
+
+struct Sse2Ops {
+    typedef __m128d V;
+    typedef __m128d Mask;
+    static constexpr int Width = 2;
+    static V load(const double *p) { return _mm_loadu_pd(p); }
+    static V gather(const double *base, const int *index) { return _mm_set_pd(base[index[1]], base[index[0]]); }
+    static void store(double *p, V v) { _mm_storeu_pd(p, v); }
+    static V set(double v) { return _mm_set1_pd(v); }
+    static V add(V a, V b) { return _mm_add_pd(a, b); }
+    static V sub(V a, V b) { return _mm_sub_pd(a, b); }
+    static V mul(V a, V b) { return _mm_mul_pd(a, b); }
+    static V div(V a, V b) { return _mm_div_pd(a, b); }
+    static V sqrt(V a) { return _mm_sqrt_pd(a); }
+    static V min(V a, V b) { return _mm_min_pd(a, b); }
+    static V max(V a, V b) { return _mm_max_pd(a, b); }
+    static V abs(V a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+    static Mask less(V a, V b) { return _mm_cmplt_pd(a, b); }
+    static V select(Mask mask, V a, V b) { return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b)); }
+    static V flipSign(V a, V sign) { return _mm_xor_pd(a, _mm_and_pd(sign, _mm_set1_pd(-0.0))); }
+    static bool any(Mask mask) { return _mm_movemask_pd(mask) != 0; }
+};
+
+}
+
+void Kernels::fillSse2(Table &table) {
+    fillNumeric<Sse2Ops>(table);
+}
+
+#endif // KERNELS_HAVE_X86
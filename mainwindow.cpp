@@ -17,15 +17,18 @@
 #include <algorithm>
 
 // Professional Paragliding IGC Analyzer - MainWindow Implementation
-MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), analyzer(new IGCAnalyzer(this)) {
+MainWindow::MainWindow(QWidget *parent)
+    : QMainWindow(parent), analyzer(std::make_shared<IGCAnalyzer>()), worker(new AnalysisWorker(this)) {
     setWindowIcon(createParaglidingIcon());
     setupMenuBar();
     setupUI();
     setupStatusBar();
     applyProfessionalStyle();
 
-    connect(analyzer, &IGCAnalyzer::analysisProgress, this, &MainWindow::onAnalysisProgress);
-    connect(analyzer, &IGCAnalyzer::analysisComplete, this, &MainWindow::onAnalysisComplete);
+    connect(worker, &AnalysisWorker::progress, this, &MainWindow::onAnalysisProgress);
+    connect(worker, &AnalysisWorker::finished, this, &MainWindow::onJobFinished);
+    connect(worker, &AnalysisWorker::failed, this, &MainWindow::onJobFailed);
+    connect(worker, &AnalysisWorker::cancelled, this, &MainWindow::onJobCancelled);
 }
 
 MainWindow::~MainWindow() = default;
@@ -104,6 +107,7 @@ void MainWindow::setupMenuBar() {
     calculateXCAction->setShortcut(Qt::CTRL + Qt::Key_X);
     calculateXCAction->setStatusTip("Calculate cross-country distances and OLC scoring");
     calculateXCAction->setEnabled(false);
+    connect(calculateXCAction, &QAction::triggered, this, &MainWindow::calculateXC);
     analysisMenu->addAction(calculateXCAction);
 
     // Store actions for later reference
@@ -233,7 +237,12 @@ void MainWindow::setupUI() {
     progressBar = new QProgressBar();
     progressBar->setVisible(false);
     progressBar->setObjectName("AnalysisProgress");
-    controlLayout->addWidget(progressBar, 6, 0, 1, 2);
+    controlLayout->addWidget(progressBar, 6, 0);
+
+    cancelButton = new QPushButton("✖ Cancel");
+    cancelButton->setObjectName("ActionButton");
+    cancelButton->setVisible(false);
+    controlLayout->addWidget(cancelButton, 6, 1);
 
     leftLayout->addWidget(controlGroup);
     leftLayout->addStretch();
@@ -319,6 +328,7 @@ void MainWindow::setupUI() {
     connect(analyzeButton, &QPushButton::clicked, this, &MainWindow::analyzeThermals);
     connect(saveButton, &QPushButton::clicked, this, &MainWindow::saveWaypoints);
     connect(exportButton, &QPushButton::clicked, this, &MainWindow::exportReport);
+    connect(cancelButton, &QPushButton::clicked, this, &MainWindow::cancelAnalysis);
     connect(thermalTable, &QTableWidget::itemSelectionChanged,
             this, &MainWindow::onThermalTableSelectionChanged);
 
@@ -339,57 +349,38 @@ void MainWindow::openIGCFile() {
         );
 
     if (!fileName.isEmpty()) {
-        if (analyzer->loadIGCFile(fileName)) {
-            currentFileName = fileName;
-
-            // Update UI state
-            analyzeButton->setEnabled(true);
-            analyzeThermalsMenuAction->setEnabled(true);
-            calculateXCMenuAction->setEnabled(true);
-
-            updateFlightInfo();
-            updateOverview();
-            updateStatusBar();
-
-            QFileInfo fileInfo(fileName);
-            QMessageBox::information(this, "Flight Loaded Successfully",
-                                     QString("IGC flight file loaded successfully!\n\n"
-                                             "File: %1\n"
-                                             "Data Points: %2\n"
-                                             "Ready for thermal analysis.")
-                                         .arg(fileInfo.fileName())
-                                         .arg(analyzer->getFlightData().size()));
-        } else {
-            QMessageBox::critical(this, "Error Loading Flight",
-                                  "Failed to load IGC file!\n\n"
-                                  "Please ensure the file is a valid IGC format.");
-        }
+        // Loading replaces whatever the running job was working on
+        loadingFileName = fileName;
+        pendingReportFile.clear();
+        worker->load(fileName);
+        setBusy(true, QString("Loading %1...").arg(QFileInfo(fileName).fileName()));
     }
 }
 
 void MainWindow::analyzeThermals() {
-    if (analyzer->getFlightData().empty()) {
+    if (analyzer->getTrack().empty()) {
         QMessageBox::warning(this, "No Flight Data",
                             "No flight data loaded!\n\nPlease open an IGC file first.");
         return;
     }
 
-    // Update UI state for analysis
-    analyzeButton->setEnabled(false);
-    progressBar->setVisible(true);
-    progressBar->setValue(0);
+    ThermalParameters parameters = analyzer->getThermalParameters();
+    parameters.minClimbRate = climbRateSpinBox->value();
+    parameters.radius = radiusSpinBox->value();
 
-    statusBar()->showMessage("Analyzing flight for thermal activity...");
+    worker->analyzeThermals(*analyzer, parameters);
+    setBusy(true, "Analyzing flight for thermal activity...");
+}
 
-    double minClimbRate = climbRateSpinBox->value();
-    double thermalRadius = radiusSpinBox->value();
+void MainWindow::calculateXC() {
+    if (analyzer->getTrack().empty()) return;
 
-    // Run analysis
-    analyzer->analyzeForThermals(minClimbRate, thermalRadius);
+    worker->score(*analyzer);
+    setBusy(true, "Optimizing cross-country distance...");
 }
 
 void MainWindow::saveWaypoints() {
-    if (analyzer->getThermals().empty()) {
+    if (!analyzer->isComputed(IGCAnalyzer::Thermals) || analyzer->getThermals().empty()) {
         QMessageBox::warning(this, "No Thermals Found",
                             "No thermals found to save!\n\nPlease analyze the flight first.");
         return;
@@ -417,7 +408,7 @@ void MainWindow::saveWaypoints() {
 }
 
 void MainWindow::exportReport() {
-    if (analyzer->getFlightData().empty()) {
+    if (analyzer->getTrack().empty()) {
         QMessageBox::warning(this, "No Flight Data", "No flight data to export!");
         return;
     }
@@ -432,8 +423,15 @@ void MainWindow::exportReport() {
         "HTML Report (*.html);;Text Report (*.txt);;All Files (*)"
         );
 
-    if (!fileName.isEmpty()) {
+    if (fileName.isEmpty()) return;
+
+    // A report carries the scores, so score first when nothing has yet
+    if (analyzer->isComputed(IGCAnalyzer::Scores)) {
         generateDetailedReport(fileName);
+    } else {
+        pendingReportFile = fileName;
+        worker->score(*analyzer);
+        setBusy(true, "Optimizing cross-country distance for the report...");
     }
 }
 
@@ -445,6 +443,7 @@ void MainWindow::generateDetailedReport(const QString &fileName) {
     }
 
     QTextStream out(&file);
+    const bool haveThermals = analyzer->isComputed(IGCAnalyzer::Thermals) && !analyzer->getThermals().empty();
 
     if (fileName.endsWith(".html")) {
         // HTML Report
@@ -469,7 +468,7 @@ void MainWindow::generateDetailedReport(const QString &fileName) {
         out << analyzer->getFlightInfo();
         out << "</div>\n";
 
-        if (!analyzer->getThermals().empty()) {
+        if (haveThermals) {
             out << "<div class='section'>\n";
             out << analyzer->getThermalSummary();
             out << "</div>\n";
@@ -487,7 +486,7 @@ void MainWindow::generateDetailedReport(const QString &fileName) {
         flightInfo.remove(QRegularExpression("<[^>]*>"));
         out << flightInfo << "\n\n";
 
-        if (!analyzer->getThermals().empty()) {
+        if (haveThermals) {
             QString thermalInfo = analyzer->getThermalSummary();
             thermalInfo.remove(QRegularExpression("<[^>]*>"));
             out << thermalInfo << "\n";
@@ -515,26 +514,83 @@ void MainWindow::showAbout() {
                        "<p>© 2025 Türkay Biliyor Paragliding. All rights reserved.</p>");
 }
 
-void MainWindow::onAnalysisProgress(int percentage) {
+void MainWindow::cancelAnalysis() {
+    worker->cancel();
+}
+
+void MainWindow::onAnalysisProgress(int percentage, const QString &stage) {
     progressBar->setValue(percentage);
-    statusBar()->showMessage(QString("Analyzing flight... %1%").arg(percentage));
+    statusBar()->showMessage(QString("%1 %2%").arg(stage).arg(percentage));
 }
 
-void MainWindow::onAnalysisComplete() {
-    progressBar->setVisible(false);
-    analyzeButton->setEnabled(true);
+void MainWindow::onJobFinished(AnalysisWorker::Job job, std::shared_ptr<const IGCAnalyzer> snapshot) {
+    analyzer = std::move(snapshot);
+    setBusy(false);
+
+    switch (job) {
+    case AnalysisWorker::Load: {
+        currentFileName = loadingFileName;
+        thermalDetailsBrowser->clear();
+        updateThermalTable();
+        updateThermalStats();
+        updateFlightInfo();
+        updateOverview();
+        updateXCAnalysis();
+        updateStatusBar();
+
+        QFileInfo fileInfo(currentFileName);
+        QMessageBox::information(this, "Flight Loaded Successfully",
+                                 QString("IGC flight file loaded successfully!\n\n"
+                                         "File: %1\n"
+                                         "Data Points: %2\n"
+                                         "Ready for thermal analysis.")
+                                     .arg(fileInfo.fileName())
+                                     .arg(analyzer->getTrack().size()));
+        break;
+    }
+    case AnalysisWorker::Thermals:
+        updateFlightInfo();
+        updateOverview();
+        onAnalysisComplete();
+        break;
+    case AnalysisWorker::Scores:
+        updateFlightInfo();
+        updateOverview();
+        updateXCAnalysis();
+        if (!pendingReportFile.isEmpty()) {
+            generateDetailedReport(pendingReportFile);
+            pendingReportFile.clear();
+        } else {
+            tabWidget->setCurrentIndex(2);
+        }
+        statusBar()->showMessage("XC analysis complete", 3000);
+        break;
+    }
+}
+
+void MainWindow::onJobFailed(AnalysisWorker::Job job) {
+    setBusy(false);
+    if (job == AnalysisWorker::Load) {
+        QMessageBox::critical(this, "Error Loading Flight",
+                              "Failed to load IGC file!\n\n"
+                              "Please ensure the file is a valid IGC format.");
+    }
+}
 
+void MainWindow::onJobCancelled(AnalysisWorker::Job job) {
+    // The snapshot on screen stays as it was
+    pendingReportFile.clear();
+    setBusy(false);
+    statusBar()->showMessage(job == AnalysisWorker::Load ? "Loading cancelled" : "Analysis cancelled", 3000);
+}
+
+void MainWindow::onAnalysisComplete() {
     updateThermalTable();
     updateThermalStats();
     updateXCAnalysis();
     updateStatusBar();
 
     if (!analyzer->getThermals().empty()) {
-        saveButton->setEnabled(true);
-        exportButton->setEnabled(true);
-        saveWaypointsMenuAction->setEnabled(true);
-        exportReportMenuAction->setEnabled(true);
-
         // Switch to thermal analysis tab
         tabWidget->setCurrentIndex(1);
 
@@ -575,6 +631,11 @@ void MainWindow::onAnalysisComplete() {
 }
 
 void MainWindow::updateThermalTable() {
+    if (!analyzer->isComputed(IGCAnalyzer::Thermals)) {
+        thermalTable->setRowCount(0);
+        return;
+    }
+
     const auto &thermals = analyzer->getThermals();
     thermalTable->setRowCount(thermals.size());
 
@@ -582,9 +643,9 @@ void MainWindow::updateThermalTable() {
         const auto &thermal = thermals[i];
 
         thermalTable->setItem(i, 0, new QTableWidgetItem(thermal.name));
-        thermalTable->setItem(i, 1, new QTableWidgetItem(thermal.startTime.toString("hh:mm:ss")));
+        thermalTable->setItem(i, 1, new QTableWidgetItem(analyzer->toLocalDateTime(thermal.startTime).toString("hh:mm:ss")));
 
-        auto duration = thermal.startTime.secsTo(thermal.endTime);
+        auto duration = thermal.endTime - thermal.startTime;
         thermalTable->setItem(i, 2, new QTableWidgetItem(QTime(0,0).addSecs(duration).toString("mm:ss")));
 
         thermalTable->setItem(i, 3, new QTableWidgetItem(QString::number(thermal.averageClimbRate, 'f', 2)));
@@ -625,7 +686,8 @@ void MainWindow::updateThermalTable() {
 }
 
 void MainWindow::updateThermalStats() {
-    const auto &thermals = analyzer->getThermals();
+    static const std::vector<ThermalPoint> none;
+    const auto &thermals = analyzer->isComputed(IGCAnalyzer::Thermals) ? analyzer->getThermals() : none;
 
     if (thermals.empty()) {
         thermalCountLabel->setText("Thermals: 0");
@@ -648,6 +710,30 @@ void MainWindow::updateThermalStats() {
     totalGainLabel->setText(QString("Total Gain: %1 m").arg(totalGain, 0, 'f', 0));
 }
 
+void MainWindow::setBusy(bool busy, const QString &message) {
+    progressBar->setValue(0);
+    progressBar->setVisible(busy);
+    cancelButton->setVisible(busy);
+    updateActions();
+    if (!message.isEmpty()) statusBar()->showMessage(message);
+}
+
+void MainWindow::updateActions() {
+    // Anything that starts a job waits for the running one; saving only
+    // reads the snapshot
+    const bool idle = !worker->isBusy();
+    const bool loaded = !analyzer->getTrack().empty();
+    const bool haveThermals = analyzer->isComputed(IGCAnalyzer::Thermals) && !analyzer->getThermals().empty();
+
+    analyzeButton->setEnabled(loaded && idle);
+    analyzeThermalsMenuAction->setEnabled(loaded && idle);
+    calculateXCMenuAction->setEnabled(loaded && idle);
+    saveButton->setEnabled(haveThermals);
+    saveWaypointsMenuAction->setEnabled(haveThermals);
+    exportButton->setEnabled(haveThermals && idle);
+    exportReportMenuAction->setEnabled(haveThermals && idle);
+}
+
 void MainWindow::updateFlightInfo() {
     flightInfoBrowser->setHtml(analyzer->getFlightInfo());
 }
@@ -659,7 +745,7 @@ void MainWindow::updateOverview() {
     stream << "<h3>🪂 Flight Overview</h3>";
     stream << analyzer->getFlightInfo();
 
-    if (!analyzer->getFlightData().empty()) {
+    if (!analyzer->getTrack().empty()) {
         stream << "<br><h4>📈 Performance Summary</h4>";
         stream << "<table border='1' cellpadding='5' cellspacing='0' style='border-collapse: collapse; width: 100%;'>";
         stream << "<tr style='background-color: #f0f0f0;'>";
@@ -711,7 +797,7 @@ void MainWindow::updateXCAnalysis() {
 
     stream << "<h3>🏁 Cross-Country Performance Analysis</h3>";
 
-    if (analyzer->getFlightData().empty()) {
+    if (analyzer->getTrack().empty()) {
         stream << "<p>No flight data available for XC analysis.</p>";
         xcBrowser->setHtml(xcAnalysis);
         return;
@@ -733,26 +819,57 @@ void MainWindow::updateXCAnalysis() {
     stream << "<td>" << QString::number(straightSpeed, 'f', 1) << " km/h</td>";
     stream << "<td>" << getDistanceRating(straightDist) << "</td></tr>";
 
-    // Maximum distance
-    double maxDist = analyzer->calculateMaximumDistance();
+    // Maximum distance from takeoff, then the flight extent from the hull
+    double maxDist = analyzer->getMaximumDistance();
     double maxSpeed = duration > 0 ? maxDist / duration : 0;
     stream << "<tr><td>Maximum Distance</td><td>" << QString::number(maxDist, 'f', 1) << " km</td>";
     stream << "<td>" << QString::number(maxSpeed, 'f', 1) << " km/h</td>";
     stream << "<td>" << getDistanceRating(maxDist) << "</td></tr>";
 
-    // OLC distance
-    double olcDist = analyzer->getOLCDistance();
-    double olcSpeed = duration > 0 ? olcDist / duration : 0;
-    double olcPoints = analyzer->calculateOLCPoints();
-    stream << "<tr><td>OLC Optimized</td><td>" << QString::number(olcDist, 'f', 1) << " km</td>";
-    stream << "<td>" << QString::number(olcSpeed, 'f', 1) << " km/h</td>";
-    stream << "<td>" << getOLCRating(olcPoints) << "</td></tr>";
+    double diameter = analyzer->getFlightDiameter();
+    stream << "<tr><td>Flight Diameter</td><td>" << QString::number(diameter, 'f', 1) << " km</td>";
+    stream << "<td>-</td>";
+    stream << "<td>" << getDistanceRating(diameter) << "</td></tr>";
+
+    // OLC distance, once a job has scored the flight
+    const bool scored = analyzer->isComputed(IGCAnalyzer::Scores);
+    double olcDist = scored ? analyzer->getOLCDistance() : 0.0;
+    double olcPoints = scored ? analyzer->calculateOLCPoints() : 0.0;
+    if (scored) {
+        double olcSpeed = duration > 0 ? olcDist / duration : 0;
+        stream << "<tr><td>OLC Optimized</td><td>" << QString::number(olcDist, 'f', 1) << " km</td>";
+        stream << "<td>" << QString::number(olcSpeed, 'f', 1) << " km/h</td>";
+        stream << "<td>" << getOLCRating(olcPoints) << "</td></tr>";
+    } else {
+        stream << "<tr><td>OLC Optimized</td><td>not calculated yet</td><td>-</td><td>-</td></tr>";
+    }
+
+    // Closed triangles
+    static const TriangleResult notScored;
+    const TriangleResult &flat = scored ? analyzer->getFlatTriangle() : notScored;
+    if (flat.found) {
+        double flatSpeed = duration > 0 ? flat.distance / duration : 0;
+        stream << "<tr><td>Flat Triangle</td><td>" << QString::number(flat.distance, 'f', 1) << " km</td>";
+        stream << "<td>" << QString::number(flatSpeed, 'f', 1) << " km/h</td>";
+        stream << "<td>" << getDistanceRating(flat.distance) << "</td></tr>";
+    }
+    const TriangleResult &fai = scored ? analyzer->getFAITriangle() : notScored;
+    if (fai.found) {
+        double faiSpeed = duration > 0 ? fai.distance / duration : 0;
+        stream << "<tr><td>FAI Triangle</td><td>" << QString::number(fai.distance, 'f', 1) << " km</td>";
+        stream << "<td>" << QString::number(faiSpeed, 'f', 1) << " km/h</td>";
+        stream << "<td>" << getDistanceRating(fai.distance) << "</td></tr>";
+    }
 
     stream << "</table>";
 
     // OLC Scoring
     stream << "<h4>🏆 Competition Scoring</h4>";
-    stream << "<p><b>OLC Points:</b> " << QString::number(olcPoints, 'f', 1) << " points</p>";
+    if (scored) {
+        stream << "<p><b>OLC Points:</b> " << QString::number(olcPoints, 'f', 1) << " points</p>";
+    } else {
+        stream << "<p><b>OLC Points:</b> not calculated yet</p>";
+    }
     stream << "<p><b>Flight Category:</b> " << getFlightCategory(straightDist) << "</p>";
 
     // Performance recommendations
@@ -763,13 +880,16 @@ void MainWindow::updateXCAnalysis() {
         stream << "<li>🎯 <b>Speed Improvement:</b> Focus on finding stronger thermals and optimizing glide paths</li>";
     }
 
-    if (olcDist - straightDist > 20) {
+    if (!scored) {
+        stream << "<li>🏁 <b>Route Analysis:</b> Calculate the XC distance to score the flight</li>";
+    } else if (olcDist - straightDist > 20) {
         stream << "<li>📈 <b>Route Optimization:</b> Good XC strategy with effective use of multiple waypoints</li>";
     } else {
         stream << "<li>📍 <b>Route Planning:</b> Consider exploring wider areas to maximize XC distance</li>";
     }
 
-    const auto &thermals = analyzer->getThermals();
+    static const std::vector<ThermalPoint> none;
+    const auto &thermals = analyzer->isComputed(IGCAnalyzer::Thermals) ? analyzer->getThermals() : none;
     if (!thermals.empty()) {
         int strongThermals = std::count_if(thermals.begin(), thermals.end(),
                                          [](const ThermalPoint &t) { return t.maxClimbRate >= 4.0; });
@@ -814,16 +934,16 @@ QString MainWindow::getFlightCategory(double distance) {
 }
 
 void MainWindow::updateStatusBar() {
-    if (analyzer->getFlightData().empty()) {
+    if (analyzer->getTrack().empty()) {
         flightStatusLabel->setText("No flight loaded");
         thermalStatusLabel->setText("");
     } else {
         QString duration = QTime(0,0).addSecs(analyzer->getFlightDurationSeconds()).toString("hh:mm:ss");
         flightStatusLabel->setText(QString("Flight loaded: %1 points, %2 duration")
-                                  .arg(analyzer->getFlightData().size())
+                                  .arg(analyzer->getTrack().size())
                                   .arg(duration));
 
-        if (!analyzer->getThermals().empty()) {
+        if (analyzer->isComputed(IGCAnalyzer::Thermals) && !analyzer->getThermals().empty()) {
             thermalStatusLabel->setText(QString("%1 thermals analyzed")
                                        .arg(analyzer->getThermals().size()));
         } else {
@@ -852,12 +972,12 @@ void MainWindow::showThermalDetails(const ThermalPoint &thermal) {
 
     stream << "<table style='width: 100%; border-collapse: collapse;'>";
     stream << "<tr><td style='padding: 4px; font-weight: bold; width: 40%;'>⏰ Start Time:</td>";
-    stream << "<td style='padding: 4px;'>" << thermal.startTime.toString("hh:mm:ss") << "</td></tr>";
+    stream << "<td style='padding: 4px;'>" << analyzer->toLocalDateTime(thermal.startTime).toString("hh:mm:ss") << "</td></tr>";
 
     stream << "<tr><td style='padding: 4px; font-weight: bold;'>⏱️ End Time:</td>";
-    stream << "<td style='padding: 4px;'>" << thermal.endTime.toString("hh:mm:ss") << "</td></tr>";
+    stream << "<td style='padding: 4px;'>" << analyzer->toLocalDateTime(thermal.endTime).toString("hh:mm:ss") << "</td></tr>";
 
-    auto duration = thermal.startTime.secsTo(thermal.endTime);
+    auto duration = thermal.endTime - thermal.startTime;
     stream << "<tr><td style='padding: 4px; font-weight: bold;'>⏲️ Duration:</td>";
     stream << "<td style='padding: 4px;'>" << QTime(0,0).addSecs(duration).toString("mm:ss") << "</td></tr>";
 
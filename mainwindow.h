@@ -36,7 +36,9 @@
 #include <QPolygon>
 #include <QMenu>
 #include <QKeySequence>
+#include <memory>
 
+#include "analysisworker.h"
 #include "igcanalyzer.h"
 
 class MainWindow : public QMainWindow
@@ -50,18 +52,27 @@ public:
 private slots:
     void openIGCFile();
     void analyzeThermals();
+    void calculateXC();
     void saveWaypoints();
     void exportReport();
     void showAbout();
 
-    void onAnalysisProgress(int percentage);
+    void cancelAnalysis();
+
+    void onAnalysisProgress(int percentage, const QString &stage);
+    void onJobFinished(AnalysisWorker::Job job, std::shared_ptr<const IGCAnalyzer> snapshot);
+    void onJobFailed(AnalysisWorker::Job job);
+    void onJobCancelled(AnalysisWorker::Job job);
     void onAnalysisComplete();
     void onThermalTableSelectionChanged();
 
 private:
     // Core components
-    IGCAnalyzer *analyzer;
+    std::shared_ptr<const IGCAnalyzer> analyzer; // snapshot from the last finished job
+    AnalysisWorker *worker;
     QString currentFileName;
+    QString loadingFileName;
+    QString pendingReportFile;  // exported once the scores are in
 
     // UI Setup methods
     void setupMenuBar();
@@ -71,6 +82,8 @@ private:
     QIcon createParaglidingIcon();
 
     // Update methods
+    void setBusy(bool busy, const QString &message = QString());
+    void updateActions();
     void updateThermalTable();
     void updateThermalStats();
     void updateFlightInfo();
@@ -113,6 +126,7 @@ private:
     QPushButton *saveButton;
     QPushButton *exportButton;
     QProgressBar *progressBar;
+    QPushButton *cancelButton;
 
     // Right panel - Results tabs
     QTabWidget *tabWidget;
@@ -0,0 +1,49 @@
+// Lazy metric cache with dependency invalidation
+#include "metricregistry.h"
+#include <QtGlobal>
+
+void MetricRegistry::define(int id, const std::vector<int> &dependencies, const std::function<void()> &compute) {
+    if (id >= int(nodes.size())) nodes.resize(size_t(id) + 1);
+    Node &node = nodes[size_t(id)];
+    node.dependencies = dependencies;
+    node.compute = compute;
+    node.valid = !compute; // settings are always current
+    for (int dependency : dependencies) {
+        Q_ASSERT(dependency < id);
+        nodes[size_t(dependency)].dependents.push_back(id);
+    }
+}
+
+void MetricRegistry::require(int id) {
+    Node &node = nodes[size_t(id)];
+    if (node.valid) return;
+    Q_ASSERT(!node.computing); // a metric reached from its own computation
+
+    node.computing = true;
+    for (int dependency : node.dependencies) require(dependency);
+    node.compute();
+    node.computing = false;
+    node.valid = true;
+}
+
+bool MetricRegistry::isValid(int id) const {
+    return nodes[size_t(id)].valid;
+}
+
+void MetricRegistry::invalidate(int id) {
+    Node &node = nodes[size_t(id)];
+    if (node.compute) {
+        if (!node.valid) return; // nothing downstream can be valid either
+        node.valid = false;
+    }
+    for (int dependent : node.dependents) invalidate(dependent);
+}
+
+void MetricRegistry::invalidateAll() {
+    for (Node &node : nodes) node.valid = !node.compute;
+}
+
+void MetricRegistry::copyValidity(const MetricRegistry &other) {
+    Q_ASSERT(other.nodes.size() == nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++) nodes[i].valid = other.nodes[i].valid;
+}
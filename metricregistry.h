@@ -0,0 +1,43 @@
+#ifndef METRICREGISTRY_H
+#define METRICREGISTRY_H
+
+#include <functional>
+#include <vector>
+
+// Memoized, lazily computed values with declared dependencies.
+//
+// A node is either a metric, with a function that computes it into its
+// owner's storage, or a setting, with none. Requiring a metric brings its
+// dependencies up to date first, then computes it once; later requests are
+// free until something it reads is invalidated. Invalidating a node drops
+// every metric downstream of it, so changing one setting recomputes only
+// the metrics that read it. Not thread-safe; nodes must be defined in an
+// order where dependencies come first.
+class MetricRegistry {
+public:
+    // A setting when compute is empty
+    void define(int id, const std::vector<int> &dependencies, const std::function<void()> &compute = {});
+
+    void require(int id);
+    bool isValid(int id) const;
+
+    void invalidate(int id);    // id (unless a setting) and everything that reads it
+    void invalidateAll();
+
+    // Take over which nodes are valid from a registry with the same
+    // definitions, once the storage its metrics fill has been copied
+    void copyValidity(const MetricRegistry &other);
+
+private:
+    struct Node {
+        std::vector<int> dependencies;
+        std::vector<int> dependents;
+        std::function<void()> compute;
+        bool valid = false;
+        bool computing = false;
+    };
+
+    std::vector<Node> nodes;
+};
+
+#endif // METRICREGISTRY_H
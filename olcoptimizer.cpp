@@ -0,0 +1,652 @@
+// OLC free distance optimizer
+#include "olcoptimizer.h"
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const int InitialClusters = 256;
+const int SplitFactor = 4;
+const double Unreachable = -std::numeric_limits<double>::infinity();
+const int ParallelBlock = 16; // clusters per work item
+
+// Runs body(begin, end) over [0, count), spread over the global pool in blocks
+template<typename Body>
+void parallelFor(int count, int threads, const Body &body) {
+    if (threads <= 1 || count < 2 * ParallelBlock) {
+        body(0, count);
+        return;
+    }
+    std::vector<std::pair<int, int>> blocks;
+    const int blockSize = std::max(ParallelBlock, count / (threads * 8));
+    for (int begin = 0; begin < count; begin += blockSize) {
+        blocks.emplace_back(begin, std::min(count, begin + blockSize));
+    }
+    QtConcurrent::blockingMap(blocks, [&body](const std::pair<int, int> &block) { body(block.first, block.second); });
+}
+
+}
+
+template<typename Model>
+FreeDistanceOptimizer<Model>::FreeDistanceOptimizer(QSpan<const double> latitudes, QSpan<const double> longitudes)
+    : track(latitudes, longitudes) {
+}
+
+template<typename Model>
+typename FreeDistanceOptimizer<Model>::Cluster FreeDistanceOptimizer<Model>::makeCluster(int begin, int end) const {
+    Cluster cluster;
+    cluster.begin = begin;
+    cluster.end = end;
+    cluster.representative = begin + (end - begin) / 2;
+    for (int i = begin; i < end; i++) {
+        cluster.radius = std::max(cluster.radius, track.distanceBound(cluster.representative, i));
+    }
+    return cluster;
+}
+
+template<typename Model>
+typename FreeDistanceOptimizer<Model>::ClusterList FreeDistanceOptimizer<Model>::split(const ClusterList &clusters,
+                                                                                      int parts) const {
+    ClusterList result;
+    result.reserve(clusters.size() * parts);
+    for (const auto &cluster : clusters) {
+        const int size = cluster.end - cluster.begin;
+        if (size <= 1) {
+            result.push_back(cluster);
+            continue;
+        }
+        const int step = (size + parts - 1) / parts;
+        for (int begin = cluster.begin; begin < cluster.end; begin += step) {
+            result.push_back(makeCluster(begin, std::min(cluster.end, begin + step)));
+        }
+    }
+    return result;
+}
+
+template<typename Model>
+double FreeDistanceOptimizer<Model>::boundStages(const std::array<ClusterList, Stages> &stages, FreeDistanceResult &best,
+                                                 std::array<std::vector<double>, Stages> &through) const {
+    std::array<std::vector<double>, Stages> upper;     // best widened route ending here
+    std::array<std::vector<double>, Stages> lower;     // best real route over representatives
+    std::array<std::vector<int>, Stages> previous;
+
+    upper[0].assign(stages[0].size(), 0.0);
+    lower[0].assign(stages[0].size(), 0.0);
+    previous[0].assign(stages[0].size(), -1);
+
+    // Forward pass: stage lists are ordered by first fix, so the clusters
+    // that can precede cluster i form a prefix of the previous stage
+    for (int s = 1; s < Stages; s++) {
+        const ClusterList &from = stages[s - 1];
+        const ClusterList &to = stages[s];
+        upper[s].assign(to.size(), Unreachable);
+        lower[s].assign(to.size(), Unreachable);
+        previous[s].assign(to.size(), -1);
+
+        parallelFor(int(to.size()), threadCount, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                const Cluster &target = to[size_t(i)];
+                for (size_t j = 0; j < from.size() && from[j].begin < target.end; j++) {
+                    const Cluster &source = from[j];
+                    const double leg = track.distance(source.representative, target.representative);
+
+                    if (upper[s - 1][j] != Unreachable) {
+                        upper[s][i] = std::max(upper[s][i], upper[s - 1][j] + leg + source.radius + target.radius);
+                    }
+                    if (lower[s - 1][j] != Unreachable && source.representative <= target.representative &&
+                        lower[s - 1][j] + leg > lower[s][i]) {
+                        lower[s][i] = lower[s - 1][j] + leg;
+                        previous[s][i] = int(j);
+                    }
+                }
+            }
+        });
+    }
+
+    // Best real route found at this level
+    const std::vector<double> &finish = lower[Stages - 1];
+    const auto bestFinish = std::max_element(finish.begin(), finish.end());
+    if (bestFinish != finish.end() && *bestFinish > best.distance) {
+        best.distance = *bestFinish;
+        int index = int(bestFinish - finish.begin());
+        for (int s = Stages - 1; s >= 0; s--) {
+            best.points[s] = stages[s][index].representative;
+            index = previous[s][index];
+        }
+    }
+
+    // Backward pass: widened length of the rest of the route
+    std::array<std::vector<double>, Stages> remaining;
+    remaining[Stages - 1].assign(stages[Stages - 1].size(), 0.0);
+    for (int s = Stages - 2; s >= 0; s--) {
+        const ClusterList &from = stages[s];
+        const ClusterList &to = stages[s + 1];
+        remaining[s].assign(from.size(), Unreachable);
+
+        parallelFor(int(from.size()), threadCount, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                const Cluster &source = from[size_t(i)];
+                for (size_t k = 0; k < to.size(); k++) {
+                    const Cluster &target = to[k];
+                    if (source.begin >= target.end || remaining[s + 1][k] == Unreachable) continue;
+                    const double leg = track.distance(source.representative, target.representative);
+                    remaining[s][i] = std::max(remaining[s][i], leg + source.radius + target.radius + remaining[s + 1][k]);
+                }
+            }
+        });
+    }
+
+    double bound = 0.0;
+    for (int s = 0; s < Stages; s++) {
+        through[s].resize(stages[s].size());
+        for (size_t i = 0; i < stages[s].size(); i++) {
+            const bool reachable = upper[s][i] != Unreachable && remaining[s][i] != Unreachable;
+            through[s][i] = reachable ? upper[s][i] + remaining[s][i] : Unreachable;
+        }
+    }
+    for (double value : upper[Stages - 1]) bound = std::max(bound, value);
+    return bound;
+}
+
+template<typename Model>
+FreeDistanceResult FreeDistanceOptimizer<Model>::solve() {
+    FreeDistanceResult best;
+    const int count = track.size();
+    if (count < 2) return best;
+
+    // Coarse partition shared by all stages
+    ClusterList initial;
+    const int clusterSize = (count + InitialClusters - 1) / InitialClusters;
+    for (int begin = 0; begin < count; begin += clusterSize) {
+        initial.push_back(makeCluster(begin, std::min(count, begin + clusterSize)));
+    }
+
+    std::array<ClusterList, Stages> stages;
+    stages.fill(initial);
+    std::array<std::vector<double>, Stages> through;
+    best.upperBound = std::numeric_limits<double>::infinity();
+
+    while (true) {
+        best.upperBound = std::min(best.upperBound, boundStages(stages, best, through));
+
+        bool singletons = true;
+        for (const auto &stage : stages) {
+            for (const auto &cluster : stage) singletons = singletons && cluster.end - cluster.begin == 1;
+        }
+        if (singletons) {
+            // Every candidate is a single fix: the representative DP was exact
+            best.upperBound = best.distance;
+            break;
+        }
+
+        // Drop clusters whose best possible route cannot beat the current one,
+        // then split the survivors
+        const double threshold = best.distance * (1.0 - 1e-12);
+        qint64 pairs = 0;
+        for (int s = 0; s < Stages; s++) {
+            ClusterList kept;
+            for (size_t i = 0; i < stages[s].size(); i++) {
+                if (through[s][i] >= threshold) kept.push_back(stages[s][i]);
+            }
+            stages[s] = split(kept, SplitFactor);
+            if (s > 0) pairs += qint64(stages[s - 1].size()) * qint64(stages[s].size());
+        }
+
+        if (pairs > pairBudget || limits.expired()) break; // Report the proven bound instead
+        if (progress) progress(best.distance, std::max(best.distance, best.upperBound));
+    }
+
+    best.upperBound = std::max(best.upperBound, best.distance);
+    if (progress) progress(best.distance, best.upperBound);
+    return best;
+}
+
+namespace {
+
+const int LeafSize = 4;
+const int BoundGapVisits = 2048;    // closing gap search effort for a node bound
+const int LeafGapVisits = 8192;     // and for a candidate triangle
+const int LimitPollInterval = 64;   // expansions between deadline checks
+const int ReportInterval = 100;     // ms between progress reports
+
+// Raises an atomic maximum, returning true if value became the new maximum
+bool raiseMaximum(std::atomic<double> &maximum, double value) {
+    double seen = maximum.load(std::memory_order_relaxed);
+    while (value > seen) {
+        if (maximum.compare_exchange_weak(seen, value, std::memory_order_relaxed)) return true;
+    }
+    return false;
+}
+
+}
+
+// Shared state of one solve() call
+template<typename Model>
+struct TriangleOptimizer<Model>::Search {
+    TriangleType type = TriangleType::Flat;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<double> bestDistance{0.0};  // pruning threshold shared by all workers
+    std::atomic<qint64> pending{0};         // triples queued or being expanded
+    std::atomic<qint64> work{0};
+    std::atomic<bool> stopped{false};
+
+    QMutex reportMutex;
+    QElapsedTimer sinceReport;
+    double reportedBest = -1.0;
+    double reportedBound = std::numeric_limits<double>::infinity(); // tightest bound seen so far
+};
+
+template<typename Model>
+TriangleOptimizer<Model>::TriangleOptimizer(QSpan<const double> latitudes, QSpan<const double> longitudes)
+    : track(latitudes, longitudes) {
+    if (track.size() > 0) {
+        balls.reserve(size_t(2 * track.size() / LeafSize + 2));
+        build(0, track.size());
+    }
+}
+
+template<typename Model>
+int TriangleOptimizer<Model>::build(int begin, int end) {
+    const int index = int(balls.size());
+    balls.emplace_back();
+    Ball ball;
+    ball.begin = begin;
+    ball.end = end;
+    ball.centre = begin + (end - begin) / 2;
+    for (int i = begin; i < end; i++) {
+        ball.radius = std::max(ball.radius, track.distanceBound(ball.centre, i));
+    }
+    if (end - begin > LeafSize) {
+        const int middle = begin + (end - begin) / 2;
+        ball.left = build(begin, middle);
+        ball.right = build(middle, end);
+    }
+    balls[index] = ball;
+    return index;
+}
+
+template<typename Model>
+typename TriangleOptimizer<Model>::ClosingGap TriangleOptimizer<Model>::closingGap(Search &search, Worker &worker,
+                                                                                   int lastStart, int firstFinish,
+                                                                                   double limit, int visits) {
+    // Nearest pair between fixes [0, lastStart] and [firstFinish, end)
+    ClosingGap result;
+    result.limit = limit;
+    result.visits = visits;
+    if (lastStart >= firstFinish) {
+        result.start = result.finish = firstFinish;
+        return result;
+    }
+
+    const quint64 key = (quint64(quint32(lastStart)) << 32) | quint32(firstFinish);
+    const auto cached = worker.gapCache.find(key);
+    if (cached != worker.gapCache.end()) {
+        const ClosingGap &gap = cached->second;
+        if (gap.resolved(limit) || (gap.limit >= limit && gap.visits >= visits)) return gap;
+    }
+
+    // Dual-tree search, pruning node pairs that cannot beat the best pair so
+    // far. Pairs left on the stack when the visit budget runs out still bound
+    // the gap from below.
+    struct Pending {
+        int head;
+        int tail;
+        double lower;
+    };
+    std::vector<Pending> stack;
+    auto push = [&](int head, int tail) {
+        const Ball &a = balls[size_t(head)];
+        const Ball &b = balls[size_t(tail)];
+        if (a.begin > lastStart || b.end <= firstFinish) return;
+        const double lower = std::max(0.0, track.distance(a.centre, b.centre) - a.radius - b.radius);
+        if (lower <= std::min(limit, result.distance)) stack.push_back({head, tail, lower});
+    };
+
+    result.distance = std::numeric_limits<double>::infinity();
+    push(0, 0);
+    int visited = 0;
+    while (!stack.empty() && visited < visits) {
+        const Pending pending = stack.back();
+        stack.pop_back();
+        if (pending.lower > std::min(limit, result.distance)) continue;
+        visited++;
+
+        const Ball &head = balls[size_t(pending.head)];
+        const Ball &tail = balls[size_t(pending.tail)];
+        if (head.left < 0 && tail.left < 0) {
+            const int headEnd = std::min(head.end, lastStart + 1);
+            for (int s = head.begin; s < headEnd; s++) {
+                for (int f = std::max(tail.begin, firstFinish); f < tail.end; f++) {
+                    const double distance = track.distance(s, f);
+                    if (distance <= limit && distance < result.distance) {
+                        result.distance = distance;
+                        result.start = s;
+                        result.finish = f;
+                    }
+                }
+            }
+        } else if (tail.left < 0 || (head.left >= 0 && head.radius >= tail.radius)) {
+            // Push the nearer child last so it is searched first
+            const bool leftFirst = track.planeDistance(balls[size_t(head.left)].centre, tail.centre) <=
+                                   track.planeDistance(balls[size_t(head.right)].centre, tail.centre);
+            push(leftFirst ? head.right : head.left, pending.tail);
+            push(leftFirst ? head.left : head.right, pending.tail);
+        } else {
+            const bool leftFirst = track.planeDistance(head.centre, balls[size_t(tail.left)].centre) <=
+                                   track.planeDistance(head.centre, balls[size_t(tail.right)].centre);
+            push(pending.head, leftFirst ? tail.right : tail.left);
+            push(pending.head, leftFirst ? tail.left : tail.right);
+        }
+    }
+
+    result.lower = std::min(result.distance, limit);
+    for (const Pending &pending : stack) {
+        if (pending.lower <= std::min(limit, result.distance)) result.lower = std::min(result.lower, pending.lower);
+    }
+    search.work.fetch_add(visited, std::memory_order_relaxed);
+    worker.gapCache[key] = result;
+    return result;
+}
+
+template<typename Model>
+double TriangleOptimizer<Model>::boundTriple(Search &search, Worker &worker, const std::array<int, 3> &nodes) {
+    // Bound for a triple of tree nodes, or a negative value if no triangle fits
+    const Ball &first = balls[size_t(nodes[0])];
+    const Ball &second = balls[size_t(nodes[1])];
+    const Ball &third = balls[size_t(nodes[2])];
+    // Turnpoints must be in time order
+    if (first.begin >= second.end || second.begin >= third.end) return -1.0;
+
+    std::array<double, 3> upper;
+    std::array<double, 3> lower;
+    const Ball *ends[3][2] = {{&first, &second}, {&second, &third}, {&third, &first}};
+    for (int i = 0; i < 3; i++) {
+        const double centres = track.distance(ends[i][0]->centre, ends[i][1]->centre);
+        const double radii = ends[i][0]->radius + ends[i][1]->radius;
+        upper[i] = centres + radii;
+        lower[i] = std::max(0.0, centres - radii);
+    }
+
+    double perimeter = upper[0] + upper[1] + upper[2];
+    if (search.type == TriangleType::FAI) {
+        const double minorRatio = faiLegFraction / (1.0 - faiLegFraction);
+        for (int i = 0; i < 3; i++) {
+            // A leg can be at most 72% of the perimeter, so the other two
+            // bound it from below and it bounds the perimeter from above
+            if (upper[i] < minorRatio * (lower[(i + 1) % 3] + lower[(i + 2) % 3])) return -1.0;
+            perimeter = std::min(perimeter, upper[i] / faiLegFraction);
+        }
+    }
+
+    // Closing gap is smallest for the latest first turnpoint and the earliest last one
+    const double limit = closingFraction * perimeter;
+    const double gap = closingGap(search, worker, first.end - 1, third.begin, limit, BoundGapVisits).lower;
+    if (gap > limit) return -1.0;
+    return perimeter - gap;
+}
+
+template<typename Model>
+void TriangleOptimizer<Model>::offer(Search &search, Worker &worker, const TriangleResult &candidate) {
+    if (candidate.distance <= worker.best.distance) return;
+    worker.best = candidate;
+    if (raiseMaximum(search.bestDistance, candidate.distance)) report(search, false);
+}
+
+template<typename Model>
+void TriangleOptimizer<Model>::tryTriangle(Search &search, Worker &worker, const std::array<int, 3> &turnpoints) {
+    const int a = turnpoints[0];
+    const int b = turnpoints[1];
+    const int c = turnpoints[2];
+    if (a > b || b > c) return;
+    const double out = track.distance(a, b);
+    const double back = track.distance(b, c);
+    const double closing = track.distance(a, c);
+    const double perimeter = out + back + closing;
+    if (search.type == TriangleType::FAI && std::min({out, back, closing}) < faiLegFraction * perimeter) return;
+
+    // Any pair found is a valid closing, even if the search was cut short
+    const double best = search.bestDistance.load(std::memory_order_relaxed);
+    const double limit = std::min(closingFraction * perimeter, perimeter - best);
+    if (limit < 0.0) return;
+    const ClosingGap gap = closingGap(search, worker, a, c, limit, BoundGapVisits);
+    if (gap.distance > limit || perimeter - gap.distance <= best) return;
+
+    TriangleResult candidate;
+    candidate.found = true;
+    candidate.distance = perimeter - gap.distance;
+    candidate.perimeter = perimeter;
+    candidate.closingDistance = gap.distance;
+    candidate.turnpoints = turnpoints;
+    candidate.start = gap.start;
+    candidate.finish = gap.finish;
+    offer(search, worker, candidate);
+}
+
+template<typename Model>
+void TriangleOptimizer<Model>::evaluateLeaves(Search &search, Worker &worker, const std::array<int, 3> &nodes) {
+    const Ball &first = balls[size_t(nodes[0])];
+    const Ball &second = balls[size_t(nodes[1])];
+    const Ball &third = balls[size_t(nodes[2])];
+
+    for (int a = first.begin; a < first.end; a++) {
+        for (int c = std::max(third.begin, a); c < third.end; c++) {
+            // Best second turnpoint for this pair of outer turnpoints
+            double perimeter = -1.0;
+            int turn = -1;
+            const double closing = track.distance(a, c);
+            for (int b = std::max(second.begin, a); b < second.end && b <= c; b++) {
+                const double out = track.distance(a, b);
+                const double back = track.distance(b, c);
+                const double total = out + back + closing;
+                if (search.type == TriangleType::FAI &&
+                    std::min({out, back, closing}) < faiLegFraction * total) continue;
+                if (total > perimeter) {
+                    perimeter = total;
+                    turn = b;
+                }
+            }
+            if (turn < 0) continue;
+
+            const double best = search.bestDistance.load(std::memory_order_relaxed);
+            const double limit = std::min(closingFraction * perimeter, perimeter - best);
+            if (limit < 0.0) continue;
+            const ClosingGap gap = closingGap(search, worker, a, c, limit, LeafGapVisits);
+            if (!gap.resolved(limit)) raiseMaximum(worker.unresolved, perimeter - gap.lower);
+            if (gap.distance > limit || perimeter - gap.distance <= best) continue;
+
+            TriangleResult candidate;
+            candidate.found = true;
+            candidate.distance = perimeter - gap.distance;
+            candidate.perimeter = perimeter;
+            candidate.closingDistance = gap.distance;
+            candidate.turnpoints = {a, turn, c};
+            candidate.start = gap.start;
+            candidate.finish = gap.finish;
+            offer(search, worker, candidate);
+        }
+    }
+}
+
+template<typename Model>
+bool TriangleOptimizer<Model>::take(Search &search, int index, Candidate &candidate) {
+    Worker &self = *search.workers[size_t(index)];
+    {
+        QMutexLocker locker(&self.mutex);
+        if (!self.queue.empty() && self.queue.front().bound <= search.bestDistance.load(std::memory_order_relaxed)) {
+            // Nothing left here can beat the best triangle
+            search.pending.fetch_sub(qint64(self.queue.size()));
+            self.queue.clear();
+        }
+        if (!self.queue.empty()) {
+            std::pop_heap(self.queue.begin(), self.queue.end());
+            candidate = self.queue.back();
+            self.queue.pop_back();
+            self.current.store(candidate.bound);
+            return true;
+        }
+    }
+
+    // Steal the better half of another worker's heap
+    const int count = int(search.workers.size());
+    for (int step = 1; step < count; step++) {
+        Worker &victim = *search.workers[size_t((index + step) % count)];
+        std::vector<Candidate> stolen;
+        {
+            QMutexLocker locker(&victim.mutex);
+            const size_t half = (victim.queue.size() + 1) / 2;
+            for (size_t i = 0; i < half; i++) {
+                std::pop_heap(victim.queue.begin(), victim.queue.end());
+                stolen.push_back(victim.queue.back());
+                victim.queue.pop_back();
+            }
+            // Cover the stolen bounds until they are back in a heap
+            if (!stolen.empty()) self.current.store(stolen.front().bound);
+        }
+        if (stolen.empty()) continue;
+
+        candidate = stolen.front();
+        QMutexLocker locker(&self.mutex);
+        for (size_t i = 1; i < stolen.size(); i++) {
+            self.queue.push_back(stolen[i]);
+            std::push_heap(self.queue.begin(), self.queue.end());
+        }
+        return true;
+    }
+    return false;
+}
+
+template<typename Model>
+void TriangleOptimizer<Model>::runWorker(Search &search, int index) {
+    Worker &self = *search.workers[size_t(index)];
+    Candidate candidate;
+    qint64 expanded = 0;
+
+    while (!search.stopped.load(std::memory_order_relaxed)) {
+        if (!take(search, index, candidate)) {
+            if (search.pending.load() == 0) break;
+            QThread::yieldCurrentThread();
+            continue;
+        }
+
+        if (candidate.bound > search.bestDistance.load(std::memory_order_relaxed)) {
+            const std::array<int, 3> &nodes = candidate.nodes;
+
+            // The centre fixes give a real triangle, which keeps the best score
+            // (and so the pruning threshold) moving before leaves are reached
+            tryTriangle(search, self, {balls[size_t(nodes[0])].centre, balls[size_t(nodes[1])].centre,
+                                       balls[size_t(nodes[2])].centre});
+
+            // Split the widest inner node; leaf triples are evaluated fix by fix
+            int widest = -1;
+            for (int i = 0; i < 3; i++) {
+                const Ball &ball = balls[size_t(nodes[i])];
+                if (ball.left >= 0 && (widest < 0 || ball.radius > balls[size_t(nodes[widest])].radius)) widest = i;
+            }
+            if (widest < 0) {
+                evaluateLeaves(search, self, nodes);
+            } else {
+                const Ball &ball = balls[size_t(nodes[widest])];
+                for (int child : {ball.left, ball.right}) {
+                    std::array<int, 3> next = nodes;
+                    next[widest] = child;
+                    const double bound = boundTriple(search, self, next);
+                    if (bound <= search.bestDistance.load(std::memory_order_relaxed)) continue;
+                    search.pending.fetch_add(1);
+                    QMutexLocker locker(&self.mutex);
+                    self.queue.push_back({bound, next});
+                    std::push_heap(self.queue.begin(), self.queue.end());
+                }
+            }
+        }
+        self.current.store(-1.0);
+        search.pending.fetch_sub(1);
+
+        expanded++;
+        if (search.work.fetch_add(1, std::memory_order_relaxed) >= workBudget ||
+            (expanded % LimitPollInterval == 0 && limits.expired())) {
+            search.stopped.store(true);
+        }
+        if (expanded % LimitPollInterval == 0) report(search, false);
+    }
+}
+
+template<typename Model>
+double TriangleOptimizer<Model>::upperBound(Search &search) const {
+    // Every triple is in some heap or covered by some worker's current bound,
+    // and it only moves between the two under a worker lock. Holding all the
+    // locks at once (in index order; take() never holds two) keeps a popped
+    // or stolen triple from slipping past the scan.
+    for (const auto &worker : search.workers) worker->mutex.lock();
+    double bound = 0.0;
+    for (const auto &worker : search.workers) {
+        bound = std::max({bound, worker->unresolved.load(), worker->current.load()});
+        if (!worker->queue.empty()) bound = std::max(bound, worker->queue.front().bound);
+    }
+    // Read last, so it covers every triple pruned before the scan
+    bound = std::max(bound, search.bestDistance.load());
+    for (auto worker = search.workers.rbegin(); worker != search.workers.rend(); ++worker) (*worker)->mutex.unlock();
+    return bound;
+}
+
+template<typename Model>
+void TriangleOptimizer<Model>::report(Search &search, bool force) {
+    if (!progress) return;
+    QMutexLocker locker(&search.reportMutex);
+    if (!force && search.sinceReport.isValid() && !search.sinceReport.hasExpired(ReportInterval)) return;
+    search.sinceReport.start();
+
+    // Every snapshot is a valid bound, so only ever report the tightest one
+    const double best = search.bestDistance.load();
+    const double bound = std::max(best, std::min(search.reportedBound, upperBound(search)));
+    if (best == search.reportedBest && bound == search.reportedBound) return;
+    search.reportedBest = best;
+    search.reportedBound = bound;
+    progress(best, bound);
+}
+
+template<typename Model>
+TriangleResult TriangleOptimizer<Model>::solve(TriangleType type) {
+    TriangleResult best;
+    if (track.size() < 3) return best;
+
+    Search search;
+    search.type = type;
+    const int threads = std::max(1, threadCount);
+    for (int i = 0; i < threads; i++) search.workers.push_back(std::make_unique<Worker>());
+
+    Worker &first = *search.workers.front();
+    const std::array<int, 3> root{0, 0, 0};
+    const double rootBound = boundTriple(search, first, root);
+    if (rootBound >= 0.0) {
+        first.queue.push_back({rootBound, root});
+        search.pending.store(1);
+    }
+
+    // The calling thread is worker 0; the others run on the global pool
+    std::vector<QFuture<void>> helpers;
+    for (int i = 1; i < threads; i++) {
+        helpers.push_back(QtConcurrent::run([this, &search, i]() { runWorker(search, i); }));
+    }
+    runWorker(search, 0);
+    for (auto &helper : helpers) helper.waitForFinished();
+
+    for (const auto &worker : search.workers) {
+        if (worker->best.distance > best.distance) best = worker->best;
+    }
+    // Only a stopped search leaves queued triples behind
+    report(search, true);
+    best.upperBound = std::max(best.distance, std::min(search.reportedBound, upperBound(search)));
+    return best;
+}
+
+template class FreeDistanceOptimizer<DistanceModels::FAISphere>;
+template class FreeDistanceOptimizer<DistanceModels::WGS84>;
+template class FreeDistanceOptimizer<DistanceModels::Flat>;
+template class TriangleOptimizer<DistanceModels::FAISphere>;
+template class TriangleOptimizer<DistanceModels::WGS84>;
+template class TriangleOptimizer<DistanceModels::Flat>;
@@ -0,0 +1,211 @@
+#ifndef OLCOPTIMIZER_H
+#define OLCOPTIMIZER_H
+
+#include "distancemodel.h"
+#include "trackprojection.h"
+#include <QAtomicInt>
+#include <QDeadlineTimer>
+#include <QMutex>
+#include <QSpan>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Cooperative stop conditions, polled by the optimizers between work units
+struct SearchLimits {
+    const QAtomicInt *cancelled = nullptr; // non-zero stops the search
+    QDeadlineTimer deadline = QDeadlineTimer(QDeadlineTimer::Forever);
+    bool expired() const { return (cancelled && cancelled->loadRelaxed() != 0) || deadline.hasExpired(); }
+};
+
+// Anytime report: best score found so far and the proven bound on any better one
+typedef std::function<void(double best, double upperBound)> ProgressCallback;
+
+// Track fixes converted once to the distance model's points for exact
+// distances, plus a plane projection for the cheap bounds and orderings used
+// in pruning (when the model's SphereRatio allows it)
+template<typename Model>
+class GeodesicTrack {
+public:
+    GeodesicTrack(QSpan<const double> latitudes, QSpan<const double> longitudes) {
+        const qsizetype count = std::min(latitudes.size(), longitudes.size());
+        points.reserve(size_t(count));
+        for (qsizetype i = 0; i < count; i++) points.push_back(Model::point(latitudes[i], longitudes[i]));
+        if (Model::SphereRatio > 0.0) plane = TrackProjection(latitudes, longitudes);
+    }
+
+    int size() const { return int(points.size()); }
+    double distance(int i, int j) const { return Model::distance(points[size_t(i)], points[size_t(j)]); } // km
+    double distanceBound(int i, int j) const { // km, >= distance(i, j)
+        return plane.isEmpty() ? distance(i, j) : Model::SphereRatio * plane.upperBound(i, j);
+    }
+    double planeDistance(int i, int j) const { // km, approximate
+        return plane.isEmpty() ? distance(i, j) : plane.distance(i, j) * 0.001;
+    }
+
+private:
+    std::vector<typename Model::Point> points;
+    TrackProjection plane;
+};
+
+// Best open route over a track: start, three turnpoints and finish, in time order
+struct FreeDistanceResult {
+    double distance = 0.0;          // km, length of the route in points
+    double upperBound = 0.0;        // km, no route on the track is longer
+    std::array<int, 5> points{};    // track indices: start, TP1, TP2, TP3, finish
+    bool isExact() const { return upperBound - distance <= 1e-9 * std::max(1.0, distance); }
+};
+
+// Exact OLC free distance over the full-resolution track.
+//
+// Dynamic programming over the five route stages is exact but quadratic in
+// the number of candidate fixes, so candidates are narrowed first. The track
+// is cut into contiguous clusters, each with a representative fix and a
+// radius. Stage DP over representatives gives a lower bound (a real route);
+// the same DP with every leg widened by both cluster radii gives, per stage
+// and cluster, an upper bound on any route passing through it. Clusters that
+// cannot beat the lower bound are dropped, survivors are split, and the
+// process repeats until all clusters are single fixes - at which point the
+// DP is exact. If the survivors exceed the pair budget the search stops early
+// and reports the proven upper bound alongside the best route.
+template<typename Model = DistanceModels::FAISphere>
+class FreeDistanceOptimizer {
+public:
+    FreeDistanceOptimizer(QSpan<const double> latitudes, QSpan<const double> longitudes);
+
+    void setPairBudget(qint64 pairs) { pairBudget = pairs; }
+    void setThreadCount(int threads) { threadCount = threads; }
+    void setLimits(const SearchLimits &searchLimits) { limits = searchLimits; }
+    void setProgressCallback(const ProgressCallback &callback) { progress = callback; }
+    FreeDistanceResult solve();
+
+private:
+    static constexpr int Stages = 5;
+
+    struct Cluster {
+        int begin = 0;      // first fix
+        int end = 0;        // one past the last fix
+        int representative = 0;
+        double radius = 0.0; // km, bounds the farthest member from the representative
+    };
+    typedef std::vector<Cluster> ClusterList;
+
+    Cluster makeCluster(int begin, int end) const;
+    ClusterList split(const ClusterList &clusters, int parts) const;
+    double boundStages(const std::array<ClusterList, Stages> &stages, FreeDistanceResult &best,
+                       std::array<std::vector<double>, Stages> &through) const;
+
+    GeodesicTrack<Model> track;
+    qint64 pairBudget = 20000000;
+    int threadCount = 1;
+    SearchLimits limits;
+    ProgressCallback progress;
+};
+
+enum class TriangleType {
+    Flat,   // any closed triangle
+    FAI     // every leg at least 28% of the perimeter
+};
+
+// Best closed triangle: three turnpoints plus the start/finish pair that closes it
+struct TriangleResult {
+    bool found = false;
+    double distance = 0.0;          // km, perimeter minus closing distance
+    double perimeter = 0.0;         // km
+    double closingDistance = 0.0;   // km, start to finish
+    double upperBound = 0.0;        // km, no valid triangle scores more
+    std::array<int, 3> turnpoints{};
+    int start = 0;                  // closing pair, start <= TP1 and finish >= TP3
+    int finish = 0;
+    bool isExact() const { return upperBound - distance <= 1e-9 * std::max(1.0, distance); }
+};
+
+// Closed triangle optimizer (flat or FAI) by branch and bound.
+//
+// The track is indexed by a binary tree of contiguous fix ranges, each node
+// bounded by a ball (centre fix and radius). A search node is a triple of
+// tree nodes, one per turnpoint. Its legs are bounded above and below from
+// the balls, which caps the perimeter (and, for FAI, rules out triples whose
+// legs cannot meet the 28% rule). The closing distance is bounded below by
+// the nearest pair between the fixes before the first range and after the
+// last one. Triples are expanded best bound first and pruned against the
+// best real triangle so far; leaf triples are evaluated fix by fix. When the
+// work budget runs out the result carries the proven upper bound instead.
+template<typename Model = DistanceModels::FAISphere>
+class TriangleOptimizer {
+public:
+    TriangleOptimizer(QSpan<const double> latitudes, QSpan<const double> longitudes);
+
+    // Largest allowed start-finish gap as a fraction of the perimeter
+    void setClosingFraction(double fraction) { closingFraction = fraction; }
+    // Search effort in node expansions plus closing gap visits; past it the
+    // best triangle so far is returned with the proven bound
+    void setWorkBudget(qint64 steps) { workBudget = steps; }
+    void setThreadCount(int threads) { threadCount = threads; }
+    void setLimits(const SearchLimits &searchLimits) { limits = searchLimits; }
+    void setProgressCallback(const ProgressCallback &callback) { progress = callback; }
+
+    TriangleResult solve(TriangleType type);
+
+private:
+    struct Ball {
+        int begin = 0;
+        int end = 0;
+        int centre = 0;
+        double radius = 0.0;
+        int left = -1;      // children, -1 for a leaf
+        int right = -1;
+    };
+    // Nearest start/finish pair around a turnpoint range, possibly unresolved
+    struct ClosingGap {
+        double lower = 0.0;     // km, no pair is closer
+        double distance = 0.0;  // km, best pair found, infinite if none within the limit
+        double limit = 0.0;     // km, pairs farther than this were not searched
+        int visits = 0;         // node pairs the search was allowed to visit
+        int start = -1;
+        int finish = -1;
+        bool resolved(double within) const { return lower >= std::min(distance, within); }
+    };
+    struct Candidate {
+        double bound;
+        std::array<int, 3> nodes;
+        bool operator<(const Candidate &other) const { return bound < other.bound; }
+    };
+    // Per-thread search state. Each worker expands triples from its own heap
+    // and steals the better half of another worker's heap when it runs dry.
+    struct Worker {
+        QMutex mutex;                           // guards queue
+        std::vector<Candidate> queue;           // max-heap on bound
+        std::atomic<double> current{-1.0};      // bound of the triple being expanded
+        std::atomic<double> unresolved{0.0};    // bound left by candidates with an unresolved gap
+        std::unordered_map<quint64, ClosingGap> gapCache;
+        TriangleResult best;
+    };
+    struct Search;
+
+    int build(int begin, int end);
+    ClosingGap closingGap(Search &search, Worker &worker, int lastStart, int firstFinish, double limit, int visits);
+    double boundTriple(Search &search, Worker &worker, const std::array<int, 3> &nodes);
+    void tryTriangle(Search &search, Worker &worker, const std::array<int, 3> &turnpoints);
+    void evaluateLeaves(Search &search, Worker &worker, const std::array<int, 3> &nodes);
+    void offer(Search &search, Worker &worker, const TriangleResult &candidate);
+    bool take(Search &search, int index, Candidate &candidate);
+    void runWorker(Search &search, int index);
+    double upperBound(Search &search) const;
+    void report(Search &search, bool force);
+
+    GeodesicTrack<Model> track;
+    std::vector<Ball> balls;
+    double closingFraction = 0.2;
+    double faiLegFraction = 0.28;
+    qint64 workBudget = 20000000;
+    int threadCount = 1;
+    SearchLimits limits;
+    ProgressCallback progress;
+};
+
+#endif // OLCOPTIMIZER_H
@@ -0,0 +1,123 @@
+// One-pass flight phase classification
+#include "phaseindex.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double MovingSpeed = 3.0;     // m/s over the ground
+const double MovingClimb = 1.0;     // m/s, up or down
+const int SustainedMotion = 15;     // s of motion that makes a takeoff or landing
+const double ClimbVario = 0.2;      // m/s
+const int MinPhase = 10;            // s; shorter climbs and glides are absorbed
+const int MaxGap = 30;              // s; legs over longer gaps add no distance
+const double MaxLeg = 1000.0;       // m; longer legs are GPS jumps
+
+bool inFlight(FlightPhase phase) {
+    return phase != FlightPhase::Ground;
+}
+
+}
+
+PhaseIndex::PhaseIndex(QSpan<const int> times, QSpan<const int> altitudes, QSpan<const double> verticalSpeeds,
+                       QSpan<const double> groundSpeeds, QSpan<const float> xs, QSpan<const float> ys,
+                       const CirclingIndex &circling) {
+    const int count = int(times.size());
+    if (count == 0) return;
+
+    // Takeoff forwards and landing backwards: the ends of the first and last
+    // 15 s stretches of motion
+    auto moving = [&](int i) {
+        return groundSpeeds[i] > MovingSpeed || std::abs(verticalSpeeds[i]) > MovingClimb;
+    };
+    for (int i = 0, start = 0; i < count && takeoff < 0; i++) {
+        if (!moving(i)) start = i + 1;
+        else if (times[i] - times[start] >= SustainedMotion) takeoff = start;
+    }
+    for (int i = count - 1, end = count - 1; i >= 0 && landing < 0; i--) {
+        if (!moving(i)) end = i - 1;
+        else if (times[end] - times[i] >= SustainedMotion) landing = end;
+    }
+    if (takeoff < 0 || landing < takeoff) takeoff = landing = -1;
+
+    // Label and run-length encode in the same walk; the circling runs are
+    // ascending, so one pointer follows them
+    auto circlingRun = circling.runs().begin();
+    std::vector<double> along(size_t(count), 0.0); // m, track distance up to each fix
+    for (int i = 0; i < count; i++) {
+        if (i > 0) {
+            const int gap = times[i] - times[i-1];
+            const double leg = std::hypot(double(xs[i]) - xs[i-1], double(ys[i]) - ys[i-1]);
+            along[size_t(i)] = along[size_t(i) - 1] + (gap > 0 && gap < MaxGap && leg < MaxLeg ? leg : 0.0);
+        }
+
+        FlightPhase phase = FlightPhase::Ground;
+        if (takeoff >= 0 && i >= takeoff && i <= landing) {
+            while (circlingRun != circling.runs().end() && circlingRun->last < i) ++circlingRun;
+            if (circlingRun != circling.runs().end() && circlingRun->first <= i) phase = FlightPhase::Circling;
+            else phase = verticalSpeeds[i] > ClimbVario ? FlightPhase::Climb : FlightPhase::Glide;
+        }
+
+        if (!phases.empty() && phases.back().phase == phase) {
+            phases.back().last = i;
+        } else {
+            PhaseRun run;
+            run.phase = phase;
+            run.first = run.last = i;
+            phases.push_back(run);
+        }
+    }
+
+    // Absorb brief climbs and glides into the run before; a run of the same
+    // kind after them then joins it too
+    std::vector<PhaseRun> merged;
+    for (const PhaseRun &run : phases) {
+        const bool brief = run.phase != FlightPhase::Circling && times[run.last] - times[run.first] < MinPhase;
+        if (!merged.empty() && (merged.back().phase == run.phase ||
+                                (brief && inFlight(run.phase) && inFlight(merged.back().phase)))) {
+            merged.back().last = run.last;
+        } else {
+            merged.push_back(run);
+        }
+    }
+    phases.swap(merged);
+
+    // Figures per run, each from the last fix of the run before
+    endTime = times[count - 1];
+    startTimes.reserve(phases.size());
+    for (PhaseRun &run : phases) {
+        const int from = std::max(run.first - 1, 0);
+        run.duration = times[run.last] - times[from];
+        run.distance = along[size_t(run.last)] - along[size_t(from)];
+        run.altitudeChange = altitudes[run.last] - altitudes[from];
+        startTimes.push_back(times[run.first]);
+
+        PhaseTotals &totals = phaseTotals[int(run.phase)];
+        totals.runs++;
+        totals.duration += run.duration;
+        totals.distance += run.distance;
+        totals.altitudeChange += run.altitudeChange;
+    }
+}
+
+const PhaseRun* PhaseIndex::runAt(int time) const {
+    if (phases.empty() || time < startTimes.front() || time > endTime) return nullptr;
+    // The last run starting at or before the time
+    const auto next = std::upper_bound(startTimes.begin(), startTimes.end(), time);
+    return &phases[size_t(next - startTimes.begin()) - 1];
+}
+
+FlightPhase PhaseIndex::phaseAt(int time) const {
+    const PhaseRun *run = runAt(time);
+    return run ? run->phase : FlightPhase::Ground;
+}
+
+const char* PhaseIndex::name(FlightPhase phase) {
+    switch (phase) {
+    case FlightPhase::Ground: return "Ground";
+    case FlightPhase::Glide: return "Glide";
+    case FlightPhase::Climb: return "Climb";
+    case FlightPhase::Circling: return "Circling";
+    }
+    return "";
+}
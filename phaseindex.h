@@ -0,0 +1,74 @@
+#ifndef PHASEINDEX_H
+#define PHASEINDEX_H
+
+#include "circlingindex.h"
+#include <QSpan>
+#include <vector>
+
+enum class FlightPhase : unsigned char {
+    Ground,     // before takeoff and after landing
+    Glide,
+    Climb,      // climbing without circling: ridge, wave, straight lift
+    Circling
+};
+
+// A maximal stretch of one phase. Figures run from the last fix of the
+// previous run, so the runs of a flight add up to the whole flight.
+struct PhaseRun {
+    FlightPhase phase = FlightPhase::Ground;
+    int first = 0;              // fixes [first, last]
+    int last = 0;
+    int duration = 0;           // s
+    double distance = 0.0;      // m along the track
+    int altitudeChange = 0;     // m
+
+    double glideRatio() const { return altitudeChange < 0 ? distance / -altitudeChange : 0.0; } // 0 without height loss
+};
+
+// Sums over every run of one phase
+struct PhaseTotals {
+    int runs = 0;
+    int duration = 0;           // s
+    double distance = 0.0;      // m
+    int altitudeChange = 0;     // m
+
+    double glideRatio() const { return altitudeChange < 0 ? distance / -altitudeChange : 0.0; }
+};
+
+// Flight phases as run-length intervals, classified in one pass.
+//
+// Takeoff is the first fix from which the glider keeps moving (over 3 m/s
+// ground speed or 1 m/s vertical) for 15 s, landing the last fix such a
+// stretch ends on. In between, circling comes from the circling index,
+// then climb or glide from the vario. Runs of climb or glide shorter than
+// 10 s are absorbed by the run before, so lift crossed on a glide does not
+// split it. Lookups by time are a binary search over the runs.
+class PhaseIndex {
+public:
+    PhaseIndex() = default;
+    PhaseIndex(QSpan<const int> times, QSpan<const int> altitudes, QSpan<const double> verticalSpeeds,
+               QSpan<const double> groundSpeeds, QSpan<const float> xs, QSpan<const float> ys,
+               const CirclingIndex &circling);
+
+    bool isEmpty() const { return phases.empty(); }
+    const std::vector<PhaseRun>& runs() const { return phases; }
+
+    const PhaseRun* runAt(int time) const; // nullptr outside the track
+    FlightPhase phaseAt(int time) const;   // Ground outside the track
+    const PhaseTotals& totals(FlightPhase phase) const { return phaseTotals[int(phase)]; }
+
+    int takeoffFix() const { return takeoff; } // -1 when the glider never flew
+    int landingFix() const { return landing; }
+
+    static const char* name(FlightPhase phase);
+
+private:
+    std::vector<PhaseRun> phases;
+    std::vector<int> startTimes;    // time of each run's first fix
+    int endTime = 0;                // of the last fix
+    PhaseTotals phaseTotals[4];
+    int takeoff = -1;
+    int landing = -1;
+};
+
+#endif // PHASEINDEX_H
@@ -0,0 +1,118 @@
+// Parallel OLC scoring with anytime bounds
+#include "scoringengine.h"
+#include <QThread>
+
+ScoringEngine::ScoringEngine(QObject *parent) : QObject(parent), threadCount(QThread::idealThreadCount()) {
+}
+
+void ScoringEngine::setTimeBudget(int milliseconds) {
+    if (timeBudget == milliseconds) return;
+    timeBudget = milliseconds;
+    emit searchSettingsChanged();
+}
+
+void ScoringEngine::setThreadCount(int threads) {
+    if (threadCount == threads) return;
+    threadCount = threads;
+    emit searchSettingsChanged();
+}
+
+void ScoringEngine::setTolerance(double metres) {
+    if (tolerance == metres) return;
+    tolerance = metres;
+    emit searchSettingsChanged();
+}
+
+void ScoringEngine::setDistanceModel(DistanceModel model) {
+    if (distanceModel == model) return;
+    distanceModel = model;
+    emit distanceModelChanged(model);
+}
+
+SearchLimits ScoringEngine::limitsFor(const QDeadlineTimer &deadline, int disciplinesLeft) const {
+    // Split what is left of the budget evenly over the remaining disciplines,
+    // so a slow search cannot starve the ones after it
+    SearchLimits limits;
+    limits.cancelled = &cancelled;
+    if (!deadline.isForever()) {
+        limits.deadline = QDeadlineTimer(deadline.remainingTime() / disciplinesLeft);
+    }
+    return limits;
+}
+
+FlightScores ScoringEngine::score(QSpan<const double> latitudes, QSpan<const double> longitudes) {
+    // One optimizer instantiation per distance model, indexed by DistanceModel
+    typedef void (ScoringEngine::*Solver)(QSpan<const double>, QSpan<const double>, const QDeadlineTimer &,
+                                          FlightScores &);
+    static const Solver solvers[] = {
+        &ScoringEngine::solve<DistanceModels::FAISphere>,
+        &ScoringEngine::solve<DistanceModels::WGS84>,
+        &ScoringEngine::solve<DistanceModels::Flat>,
+    };
+
+    FlightScores scores;
+    scores.model = distanceModel;
+    const QDeadlineTimer deadline = timeBudget > 0 ? QDeadlineTimer(timeBudget) : QDeadlineTimer(QDeadlineTimer::Forever);
+    (this->*solvers[int(distanceModel)])(latitudes, longitudes, deadline, scores);
+
+    scores.cancelled = isCancelled();
+    scores.timedOut = !scores.cancelled && deadline.hasExpired();
+    emit scoringFinished();
+    return scores;
+}
+
+template<typename Model>
+void ScoringEngine::solve(QSpan<const double> latitudes, QSpan<const double> longitudes,
+                          const QDeadlineTimer &deadline, FlightScores &scores) {
+    const int threads = std::max(1, threadCount);
+
+    // Search the simplified track, then map indices back to the full one.
+    // The optimizers poll the cancel flag themselves; between them it is
+    // checked here, so a late cancel skips the stages still to come.
+    if (isCancelled()) return;
+    scores.reduction = TrackSimplifier::reduce(latitudes, longitudes, tolerance);
+    if (isCancelled()) return;
+    const std::vector<int> &kept = scores.reduction.indices;
+    std::vector<double> keptLatitudes(kept.size());
+    std::vector<double> keptLongitudes(kept.size());
+    for (size_t i = 0; i < kept.size(); i++) {
+        keptLatitudes[i] = latitudes[kept[i]];
+        keptLongitudes[i] = longitudes[kept[i]];
+    }
+    const QSpan<const double> reducedLatitudes(keptLatitudes);
+    const QSpan<const double> reducedLongitudes(keptLongitudes);
+
+    FreeDistanceOptimizer<Model> freeDistance(reducedLatitudes, reducedLongitudes);
+    freeDistance.setThreadCount(threads);
+    freeDistance.setLimits(limitsFor(deadline, 3));
+    freeDistance.setProgressCallback([this](double best, double upperBound) {
+        emit boundsImproved(FreeDistance, best, upperBound);
+    });
+    scores.freeDistance = freeDistance.solve();
+
+    for (int &point : scores.freeDistance.points) point = kept.empty() ? 0 : kept[size_t(point)];
+    if (isCancelled()) return;
+
+    TriangleOptimizer<Model> triangles(reducedLatitudes, reducedLongitudes);
+    triangles.setThreadCount(threads);
+    triangles.setLimits(limitsFor(deadline, 2));
+    triangles.setProgressCallback([this](double best, double upperBound) {
+        emit boundsImproved(FlatTriangle, best, upperBound);
+    });
+    scores.flatTriangle = triangles.solve(TriangleType::Flat);
+
+    if (!isCancelled()) {
+        triangles.setLimits(limitsFor(deadline, 1));
+        triangles.setProgressCallback([this](double best, double upperBound) {
+            emit boundsImproved(FAITriangle, best, upperBound);
+        });
+        scores.faiTriangle = triangles.solve(TriangleType::FAI);
+    }
+
+    for (TriangleResult *triangle : {&scores.flatTriangle, &scores.faiTriangle}) {
+        if (!triangle->found) continue;
+        for (int &turnpoint : triangle->turnpoints) turnpoint = kept[size_t(turnpoint)];
+        triangle->start = kept[size_t(triangle->start)];
+        triangle->finish = kept[size_t(triangle->finish)];
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef SCORINGENGINE_H
+#define SCORINGENGINE_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QSpan>
+
+#include "olcoptimizer.h"
+#include "tracksimplifier.h"
+
+// Scores of one flight in every OLC discipline. Indices refer to the full
+// track, but the search ran over the simplified fixes: each score is exact
+// there and, for free distance and flat triangles, at most errorBound() short
+// of the full-resolution optimum. The FAI leg rule is checked on the kept
+// fixes, so an FAI triangle right at the 28% limit can lose more.
+struct FlightScores {
+    FreeDistanceResult freeDistance;
+    TriangleResult flatTriangle;
+    TriangleResult faiTriangle;
+    TrackReduction reduction;
+    DistanceModel model = DistanceModel::FAISphere; // the scores' distances
+    bool cancelled = false;     // stopped by cancel(); results are the best found so far
+    bool timedOut = false;      // stopped by the time budget
+
+    // m, on the FAI sphere. A dropped fix lies within maxError of a segment
+    // between kept fixes, and distance to a point is largest at a segment
+    // end, so moving a route point onto kept fixes changes each leg end by at
+    // most maxError. Both route types have eight leg ends (triangles counting
+    // the closing pair).
+    double errorBound() const { return 8.0 * reduction.maxError; }
+};
+
+// Runs the OLC optimizers across the thread pool.
+//
+// The track is first reduced by TrackSimplifier. Free distance spreads each
+// refinement level over the pool; the triangle searches run one
+// work-stealing worker per thread. The optimizers are instantiated per
+// distance model and picked from a table once per call. All of them share a
+// cancel flag and a wall-clock budget and publish their best score and
+// proven bound through boundsImproved() as they go, so a caller can show a
+// usable answer long before the search is exact. score() blocks; it can be
+// called from any thread and signals are delivered queued across threads.
+class ScoringEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Discipline {
+        FreeDistance,
+        FlatTriangle,
+        FAITriangle
+    };
+    Q_ENUM(Discipline)
+
+    explicit ScoringEngine(QObject *parent = nullptr);
+
+    // Wall-clock budget for a whole score() call in ms, 0 for none
+    void setTimeBudget(int milliseconds);
+    int getTimeBudget() const { return timeBudget; }
+    void setThreadCount(int threads);
+    int getThreadCount() const { return threadCount; }
+    // Simplification tolerance in metres, 0 to search every fix
+    void setTolerance(double metres);
+    double getTolerance() const { return tolerance; }
+    void setDistanceModel(DistanceModel model);
+    DistanceModel getDistanceModel() const { return distanceModel; }
+
+    FlightScores score(QSpan<const double> latitudes, QSpan<const double> longitudes);
+
+    // Thread-safe; the running score() returns its best results so far. The
+    // cancel stays in effect, so a score() that has not started yet returns
+    // at once, until clearCancel()
+    void cancel() { cancelled.storeRelaxed(1); }
+    void clearCancel() { cancelled.storeRelaxed(0); }
+    bool isCancelled() const { return cancelled.loadRelaxed() != 0; }
+
+signals:
+    void boundsImproved(ScoringEngine::Discipline discipline, double best, double upperBound); // km
+    void scoringFinished();
+    void searchSettingsChanged();       // budget, threads or tolerance; earlier scores are stale
+    void distanceModelChanged(DistanceModel model);
+
+private:
+    SearchLimits limitsFor(const QDeadlineTimer &deadline, int disciplinesLeft) const;
+    template<typename Model>
+    void solve(QSpan<const double> latitudes, QSpan<const double> longitudes, const QDeadlineTimer &deadline,
+               FlightScores &scores);
+
+    QAtomicInt cancelled;
+    int timeBudget = 10000;
+    double tolerance = 5.0;
+    DistanceModel distanceModel = DistanceModel::FAISphere;
+    int threadCount;
+};
+
+#endif // SCORINGENGINE_H
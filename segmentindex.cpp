@@ -0,0 +1,57 @@
+// Constant-time statistics over fix ranges
+#include "segmentindex.h"
+#include <algorithm>
+
+SegmentIndex::SegmentIndex(QSpan<const int> times, QSpan<const int> altitudes, QSpan<const double> verticalSpeeds,
+                           QSpan<const float> xs, QSpan<const float> ys)
+    : time(times.begin(), times.end()), altitude(altitudes.begin(), altitudes.end()) {
+    const size_t count = altitude.size();
+    if (count == 0) return;
+
+    climbSums.assign(count + 1, 0.0);
+    weightSums.assign(count + 1, 0.0);
+    weightedXSums.assign(count + 1, 0.0);
+    weightedYSums.assign(count + 1, 0.0);
+    for (size_t i = 0; i < count; i++) {
+        const double vs = verticalSpeeds[qsizetype(i)];
+        const double weight = std::max(0.1, vs + 1.0); // better lift counts more
+        climbSums[i + 1] = climbSums[i] + vs;
+        weightSums[i + 1] = weightSums[i] + weight;
+        weightedXSums[i + 1] = weightedXSums[i] + xs[qsizetype(i)] * weight;
+        weightedYSums[i + 1] = weightedYSums[i] + ys[qsizetype(i)] * weight;
+    }
+
+    levels.assign(count + 1, 0);
+    for (size_t length = 2; length <= count; length++) levels[length] = levels[length / 2] + 1;
+
+    // Sparse table: each level doubles the run length from the one below
+    const size_t depth = size_t(levels[count]) + 1;
+    climbMaxima.resize(depth * count);
+    std::copy(verticalSpeeds.begin(), verticalSpeeds.begin() + qsizetype(count), climbMaxima.begin());
+    for (size_t level = 1; level < depth; level++) {
+        const double *below = climbMaxima.data() + (level - 1) * count;
+        double *row = climbMaxima.data() + level * count;
+        const size_t half = size_t(1) << (level - 1);
+        for (size_t i = 0; i + 2 * half <= count; i++) row[i] = std::max(below[i], below[i + half]);
+    }
+}
+
+double SegmentIndex::maxClimb(int first, int last) const {
+    const size_t level = levels[size_t(last - first) + 1];
+    const double *row = climbMaxima.data() + level * altitude.size();
+    return std::max(row[first], row[size_t(last) + 1 - (size_t(1) << level)]);
+}
+
+SegmentStats SegmentIndex::stats(int first, int last) const {
+    SegmentStats stats;
+    const size_t begin = size_t(first);
+    const size_t end = size_t(last) + 1;
+    const double weight = weightSums[end] - weightSums[begin];
+    stats.meanClimb = meanClimb(first, last);
+    stats.maxClimb = maxClimb(first, last);
+    stats.centreX = (weightedXSums[end] - weightedXSums[begin]) / weight;
+    stats.centreY = (weightedYSums[end] - weightedYSums[begin]) / weight;
+    stats.altitudeGain = altitudeGain(first, last);
+    stats.duration = duration(first, last);
+    return stats;
+}
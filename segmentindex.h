@@ -0,0 +1,47 @@
+#ifndef SEGMENTINDEX_H
+#define SEGMENTINDEX_H
+
+#include <QSpan>
+#include <vector>
+
+// What the thermal detector reports for a run of fixes
+struct SegmentStats {
+    double meanClimb = 0.0;     // m/s, mean of the fixes' vario
+    double maxClimb = 0.0;      // m/s
+    double centreX = 0.0;       // plane m, fixes weighted by max(0.1, vario + 1)
+    double centreY = 0.0;
+    int altitudeGain = 0;       // m, last fix minus first
+    int duration = 0;           // s
+};
+
+// Prefix sums and a range-maximum table over the per-fix columns, built once
+// per flight, so the statistics of any fix range cost O(1). Detection runs
+// with new parameters then only re-walk the vario, never the ranges.
+class SegmentIndex {
+public:
+    SegmentIndex() = default;
+    SegmentIndex(QSpan<const int> times, QSpan<const int> altitudes, QSpan<const double> verticalSpeeds,
+                 QSpan<const float> xs, QSpan<const float> ys);
+
+    bool isEmpty() const { return altitude.empty(); }
+    int size() const { return int(altitude.size()); }
+
+    // Fixes [first, last], first <= last
+    SegmentStats stats(int first, int last) const;
+    double meanClimb(int first, int last) const { return (climbSums[size_t(last) + 1] - climbSums[size_t(first)]) / (last - first + 1); }
+    double maxClimb(int first, int last) const;
+    int altitudeGain(int first, int last) const { return altitude[size_t(last)] - altitude[size_t(first)]; }
+    int duration(int first, int last) const { return time[size_t(last)] - time[size_t(first)]; }
+
+private:
+    std::vector<int> time;
+    std::vector<int> altitude;
+    std::vector<double> climbSums;      // prefix sums, one longer than the track
+    std::vector<double> weightSums;
+    std::vector<double> weightedXSums;
+    std::vector<double> weightedYSums;
+    std::vector<double> climbMaxima;    // level k holds the maxima of runs of 2^k fixes
+    std::vector<unsigned char> levels;  // floor(log2(length)) per run length
+};
+
+#endif // SEGMENTINDEX_H
@@ -0,0 +1,99 @@
+// Parallel chunked parsing must reproduce the sequential parse exactly
+#include <QtTest>
+#include <cstring>
+
+#include "igcanalyzer.h"
+#include "igcparser.h"
+
+namespace {
+
+const QString Fixture = QStringLiteral(IGC_TEST_DATA "/flight.igc");
+
+template<typename T>
+bool sameBits(const T &a, const T &b) {
+    return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+}
+
+class TestIGCParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void splitReachesEveryChunkCount_data();
+    void splitReachesEveryChunkCount();
+    void chunkedParseMatchesSequential_data();
+    void chunkedParseMatchesSequential();
+
+private:
+    QByteArray contents;
+    IGCAnalyzer sequential;
+};
+
+void TestIGCParser::initTestCase() {
+    QFile file(Fixture);
+    QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable(Fixture));
+    contents = file.readAll();
+
+    sequential.setParseChunks(1);
+    QVERIFY(sequential.loadIGCFile(Fixture));
+    // 3000 B-records, one with a bad digit and one cut short; the flight
+    // crosses UTC midnight
+    const FlightTrack &track = sequential.getTrack();
+    QCOMPARE(track.size(), size_t(2998));
+    QCOMPARE(track.times()[0], 23 * 3600 + 20 * 60 + 1);
+    QCOMPARE(track.times()[track.size() - 1], 24 * 3600 + 20 * 60);
+}
+
+void TestIGCParser::splitReachesEveryChunkCount_data() {
+    QTest::addColumn<int>("chunks");
+    for (int chunks = 2; chunks <= 16; chunks++) QTest::addRow("%d chunks", chunks) << chunks;
+}
+
+void TestIGCParser::splitReachesEveryChunkCount() {
+    QFETCH(int, chunks);
+    const std::vector<ParsedChunk> parts = IGCParser::splitChunks(contents.constData(), contents.size(), chunks);
+    QCOMPARE(int(parts.size()), chunks);
+
+    // Contiguous, covering the buffer and ending on line breaks
+    QCOMPARE(parts.front().begin, contents.constData());
+    QCOMPARE(parts.back().end, contents.constData() + contents.size());
+    for (size_t i = 1; i < parts.size(); i++) {
+        QCOMPARE(parts[i].begin, parts[i - 1].end);
+        QCOMPARE(*(parts[i].begin - 1), '\n');
+    }
+}
+
+void TestIGCParser::chunkedParseMatchesSequential_data() {
+    splitReachesEveryChunkCount_data();
+}
+
+void TestIGCParser::chunkedParseMatchesSequential() {
+    QFETCH(int, chunks);
+    IGCAnalyzer parallel;
+    parallel.setParseChunks(chunks);
+    QVERIFY(parallel.loadIGCFile(Fixture));
+
+    const FlightTrack &expected = sequential.getTrack();
+    const FlightTrack &actual = parallel.getTrack();
+    QCOMPARE(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        const QByteArray where = QByteArray("fix ") + QByteArray::number(qulonglong(i));
+        QVERIFY2(actual.times()[i] == expected.times()[i], where.constData());
+        QVERIFY2(sameBits(actual.latitudes()[i], expected.latitudes()[i]), where.constData());
+        QVERIFY2(sameBits(actual.longitudes()[i], expected.longitudes()[i]), where.constData());
+        QVERIFY2(actual.pressureAltitudes()[i] == expected.pressureAltitudes()[i], where.constData());
+        QVERIFY2(actual.gpsAltitudes()[i] == expected.gpsAltitudes()[i], where.constData());
+    }
+
+    QCOMPARE(parallel.getFlightEpoch(), sequential.getFlightEpoch());
+    QCOMPARE(parallel.getFlightDate(), sequential.getFlightDate());
+    QCOMPARE(parallel.getPilotName(), sequential.getPilotName());
+    QCOMPARE(parallel.getGliderType(), sequential.getGliderType());
+    QCOMPARE(parallel.getGliderID(), sequential.getGliderID());
+}
+
+QTEST_GUILESS_MAIN(TestIGCParser)
+#include "tst_igcparser.moc"
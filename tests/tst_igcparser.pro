@@ -0,0 +1,43 @@
+QT       += core concurrent testlib
+QT       -= gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_igcparser
+
+INCLUDEPATH += ..
+DEFINES += IGC_TEST_DATA=\\\"$$PWD/data\\\"
+
+SOURCES += \
+    tst_igcparser.cpp \
+    ../circlefit.cpp \
+    ../circlingindex.cpp \
+    ../distancemodel.cpp \
+    ../flightgeometry.cpp \
+    ../flightmetrics.cpp \
+    ../flighttrack.cpp \
+    ../geodesy.cpp \
+    ../igcanalyzer.cpp \
+    ../igcparser.cpp \
+    ../igcparser_avx2.cpp \
+    ../igcparser_sse2.cpp \
+    ../kernels.cpp \
+    ../kernels_avx2.cpp \
+    ../kernels_avx512.cpp \
+    ../kernels_sse2.cpp \
+    ../metricregistry.cpp \
+    ../olcoptimizer.cpp \
+    ../phaseindex.cpp \
+    ../scoringengine.cpp \
+    ../segmentindex.cpp \
+    ../thermaldetector.cpp \
+    ../trackprojection.cpp \
+    ../trackresampler.cpp \
+    ../tracksimplifier.cpp \
+    ../variofilter.cpp \
+    ../windestimator.cpp
+
+HEADERS += \
+    ../igcanalyzer.h \
+    ../scoringengine.h
@@ -0,0 +1,192 @@
+// Climb segmentation and thermal acceptance
+#include "thermaldetector.h"
+#include "circlefit.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Detection windows, in seconds so they mean the same at any logging rate
+const int SustainedSink = 5;    // sinking this long ends a climb
+const int MaxClimbSegment = 300;
+
+ClimbCandidate makeCandidate(int first, int last, double risingClimb, QSpan<const int> times, QSpan<const float> xs,
+                             QSpan<const float> ys, const SegmentIndex &index, const CirclingIndex &circling) {
+    ClimbCandidate climb;
+    climb.first = first;
+    climb.last = last;
+    climb.risingClimb = risingClimb;
+    climb.circlingTime = circling.circlingTime(first, last);
+    climb.turnRadius = circling.meanRadius(first, last);
+    climb.stats = index.stats(first, last);
+
+    double radius2 = 0;
+    for (int i = first; i <= last; i++) {
+        const double dx = xs[i] - climb.stats.centreX;
+        const double dy = ys[i] - climb.stats.centreY;
+        radius2 = std::max(radius2, dx * dx + dy * dy);
+    }
+    climb.radius = std::sqrt(radius2);
+    climb.core = ThermalDetector::fitCore(times, xs, ys, circling, first, last);
+    return climb;
+}
+
+}
+
+std::vector<ClimbCandidate> ThermalDetector::findClimbs(QSpan<const int> times, QSpan<const double> verticalSpeeds,
+                                                        QSpan<const float> xs, QSpan<const float> ys,
+                                                        const SegmentIndex &index, const CirclingIndex &circling) {
+    std::vector<ClimbCandidate> climbs;
+    const int count = int(verticalSpeeds.size());
+
+    bool inClimb = false;
+    int climbStart = 0;
+    double climbSum = 0;
+    int climbPoints = 0;
+
+    for (int i = 0; i < count; i++) {
+        const double vs = verticalSpeeds[i];
+
+        if (!inClimb && vs > 0.5) {
+            inClimb = true;
+            climbStart = i;
+            climbSum = vs;
+            climbPoints = 1;
+        } else if (inClimb) {
+            if (vs > 0) {
+                climbSum += vs;
+                climbPoints++;
+            } else {
+                // Follow the sink until it stops or has lasted long enough
+                int sinkEnd = i;
+                while (sinkEnd < count && verticalSpeeds[sinkEnd] < -0.5 &&
+                       times[sinkEnd] - times[i] < SustainedSink) {
+                    sinkEnd++;
+                }
+                const bool sustainedSink = sinkEnd < count && times[sinkEnd] - times[i] >= SustainedSink;
+
+                if (sustainedSink || times[i] - times[climbStart] > MaxClimbSegment) {
+                    if (i - 1 > climbStart) {
+                        climbs.push_back(makeCandidate(climbStart, i - 1, climbSum / climbPoints, times, xs, ys,
+                                                       index, circling));
+                    }
+                    inClimb = false;
+                    climbSum = 0;
+                    climbPoints = 0;
+                }
+            }
+        }
+    }
+    return climbs;
+}
+
+ThermalCore ThermalDetector::fitCore(QSpan<const int> times, QSpan<const float> xs, QSpan<const float> ys,
+                                     const CirclingIndex &circling, int first, int last) {
+    // Turn centres and the middle of each turn's time
+    std::vector<double> centreXs, centreYs, midTimes;
+    double radiusSum = 0.0;
+
+    CircleFit fit;
+    for (auto it = circling.firstOverlap(first); it != circling.runs().end() && it->first <= last; ++it) {
+        const CirclingRun &run = *it;
+
+        // Cut the run into turns of one period each, sharing the end fixes
+        const int begin = std::max(first, run.first);
+        const int end = std::min(last, run.last);
+        int turnStart = begin;
+        fit.clear();
+        for (int i = begin; i <= end; i++) {
+            fit.add(xs[i], ys[i]);
+            if (times[i] - times[turnStart] < run.period) continue;
+
+            double x, y, radius;
+            if (fit.solve(CircleFit::Taubin, x, y, radius)) {
+                centreXs.push_back(x);
+                centreYs.push_back(y);
+                midTimes.push_back(0.5 * (times[turnStart] + times[i]));
+                radiusSum += radius;
+            }
+            fit.clear();
+            fit.add(xs[i], ys[i]);
+            turnStart = i;
+        }
+    }
+
+    ThermalCore core;
+    core.turns = int(centreXs.size());
+    if (core.turns == 0) return core;
+    double meanTime = 0.0;
+    for (int k = 0; k < core.turns; k++) {
+        core.x += centreXs[size_t(k)];
+        core.y += centreYs[size_t(k)];
+        meanTime += midTimes[size_t(k)];
+    }
+    core.x /= core.turns;
+    core.y /= core.turns;
+    core.radius = radiusSum / core.turns;
+    meanTime /= core.turns;
+
+    // Least-squares line through the centres over time
+    double spread = 0.0;
+    for (int k = 0; k < core.turns; k++) {
+        const double dt = midTimes[size_t(k)] - meanTime;
+        core.driftX += dt * (centreXs[size_t(k)] - core.x);
+        core.driftY += dt * (centreYs[size_t(k)] - core.y);
+        spread += dt * dt;
+    }
+    if (spread > 0.0) {
+        core.driftX /= spread;
+        core.driftY /= spread;
+    } else {
+        core.driftX = core.driftY = 0.0;
+    }
+    return core;
+}
+
+bool ThermalDetector::accepts(const ClimbCandidate &climb, const ThermalParameters &parameters) {
+    // More lenient than the nominal climb rate: the mean includes the centring turns
+    return climb.risingClimb >= parameters.minClimbRate * 0.7 && climb.stats.altitudeGain > parameters.minGain &&
+           2 * climb.circlingTime >= climb.stats.duration && climb.turnRadius <= parameters.radius;
+}
+
+int ThermalDetector::strength(double maxClimbRate) {
+    if (maxClimbRate >= 5.0) return 5; // Excellent
+    if (maxClimbRate >= 3.5) return 4; // Very Good
+    if (maxClimbRate >= 2.5) return 3; // Good
+    if (maxClimbRate >= 1.5) return 2; // Fair
+    return 1;                          // Weak
+}
+
+std::vector<ThermalParameters> ThermalDetector::grid(const std::vector<double> &minClimbRates,
+                                                     const std::vector<double> &radii,
+                                                     const std::vector<int> &minGains) {
+    std::vector<ThermalParameters> settings;
+    settings.reserve(minClimbRates.size() * radii.size() * minGains.size());
+    for (double minClimbRate : minClimbRates) {
+        for (double radius : radii) {
+            for (int minGain : minGains) {
+                settings.push_back({minClimbRate, radius, minGain});
+            }
+        }
+    }
+    return settings;
+}
+
+std::vector<ThermalSweepResult> ThermalDetector::sweep(const std::vector<ClimbCandidate> &climbs,
+                                                       const std::vector<ThermalParameters> &settings) {
+    std::vector<ThermalSweepResult> results(settings.size());
+    for (size_t s = 0; s < settings.size(); s++) {
+        ThermalSweepResult &result = results[s];
+        result.parameters = settings[s];
+        for (const ClimbCandidate &climb : climbs) {
+            if (!accepts(climb, settings[s])) continue;
+            result.thermalCount++;
+            result.totalGain += climb.stats.altitudeGain;
+            result.climbingTime += climb.stats.duration;
+            result.bestClimb = std::max(result.bestClimb, climb.stats.meanClimb);
+            result.strengthCounts[strength(climb.stats.maxClimb) - 1]++;
+        }
+        if (result.climbingTime > 0) result.averageClimb = double(result.totalGain) / result.climbingTime;
+    }
+    return results;
+}
@@ -0,0 +1,84 @@
+#ifndef THERMALDETECTOR_H
+#define THERMALDETECTOR_H
+
+#include "circlingindex.h"
+#include "segmentindex.h"
+#include <QSpan>
+#include <vector>
+
+struct ThermalParameters {
+    double minClimbRate = 1.0;  // m/s; a climb must average 70% of it
+    double radius = 200.0;      // m, widest circling that counts as thermalling
+    int minGain = 30;           // m, a climb must gain more
+
+    bool operator==(const ThermalParameters &other) const {
+        return minClimbRate == other.minClimbRate && radius == other.radius && minGain == other.minGain;
+    }
+    bool operator!=(const ThermalParameters &other) const { return !(*this == other); }
+};
+
+// Circle fits of the turns in a climb. Each full turn gets its own Taubin
+// fit; the core is the mean of their centres, and the drift is the line
+// through the centres over time, so wind moving the thermal does not bias
+// either the way a mean of the fixes does.
+struct ThermalCore {
+    int turns = 0;              // turns fitted; the rest is unset without any
+    double x = 0.0;             // plane m, mean of the turn centres
+    double y = 0.0;
+    double radius = 0.0;        // m, mean fitted radius
+    double driftX = 0.0;        // m/s, east; zero below two turns
+    double driftY = 0.0;        // m/s, north
+};
+
+// A climb found by segmenting the vario. Segmentation reads no parameter,
+// so the candidates are found once per flight and every parameter choice
+// is only a filter over them.
+struct ClimbCandidate {
+    int first = 0;              // fixes [first, last]
+    int last = 0;
+    double risingClimb = 0.0;   // m/s, mean vario of the rising fixes
+    double radius = 0.0;        // m, farthest fix from the centre
+    int circlingTime = 0;       // s of the climb spent circling
+    double turnRadius = 0.0;    // m, of those circles
+    SegmentStats stats;
+    ThermalCore core;
+};
+
+// Thermals one parameter setting would report
+struct ThermalSweepResult {
+    ThermalParameters parameters;
+    int thermalCount = 0;
+    int totalGain = 0;          // m
+    int climbingTime = 0;       // s
+    double averageClimb = 0.0;  // m/s, total gain over climbing time
+    double bestClimb = 0.0;     // m/s, best thermal's mean climb
+    int strengthCounts[5] = {}; // thermals of strength 1-5
+};
+
+namespace ThermalDetector {
+
+// Starts where the vario exceeds 0.5 m/s and ends at 5 s of sink or after
+// 300 s; times in seconds, xs and ys in plane metres
+std::vector<ClimbCandidate> findClimbs(QSpan<const int> times, QSpan<const double> verticalSpeeds,
+                                       QSpan<const float> xs, QSpan<const float> ys, const SegmentIndex &index,
+                                       const CirclingIndex &circling);
+
+// A thermal is a climb spent at least half circling, in turns no wider
+// than the radius; ridge lift and straight glides through rising air are not
+ThermalCore fitCore(QSpan<const int> times, QSpan<const float> xs, QSpan<const float> ys,
+                    const CirclingIndex &circling, int first, int last);
+
+bool accepts(const ClimbCandidate &climb, const ThermalParameters &parameters);
+int strength(double maxClimbRate); // 1 (weak) to 5 (excellent)
+
+// Every combination of the given values, climb rate varying slowest
+std::vector<ThermalParameters> grid(const std::vector<double> &minClimbRates, const std::vector<double> &radii,
+                                    const std::vector<int> &minGains);
+
+// Summary per setting over shared candidates: O(candidates) each
+std::vector<ThermalSweepResult> sweep(const std::vector<ClimbCandidate> &climbs,
+                                      const std::vector<ThermalParameters> &settings);
+
+}
+
+#endif // THERMALDETECTOR_H
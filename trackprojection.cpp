@@ -0,0 +1,102 @@
+// Per-flight plane projection
+#include "trackprojection.h"
+#include "geodesy.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double Padding = 0.1; // bounding box growth per side, as a fraction of its span
+
+}
+
+TrackProjection::TrackProjection(QSpan<const double> latitudes, QSpan<const double> longitudes) {
+    const size_t count = size_t(std::min(latitudes.size(), longitudes.size()));
+    if (count == 0) return;
+
+    double minLat = latitudes[0], maxLat = latitudes[0];
+    double minLon = longitudes[0], maxLon = longitudes[0];
+    for (size_t i = 1; i < count; i++) {
+        minLat = std::min(minLat, latitudes[i]);
+        maxLat = std::max(maxLat, latitudes[i]);
+        minLon = std::min(minLon, longitudes[i]);
+        maxLon = std::max(maxLon, longitudes[i]);
+    }
+    originLat = qDegreesToRadians((minLat + maxLat) * 0.5);
+    originLon = qDegreesToRadians((minLon + maxLon) * 0.5);
+
+    // Scale bounds are taken over a slightly larger box, so straight lines
+    // between fixes stay inside the region they cover
+    const double latPad = (maxLat - minLat) * Padding;
+    const double lonPad = (maxLon - minLon) * Padding;
+    const double halfWidth = std::min(M_PI_2 * 0.99, qDegreesToRadians((maxLon - minLon) * 0.5 + lonPad));
+    double southmost = qDegreesToRadians(std::max(-89.0, minLat - latPad));
+    double northmost = qDegreesToRadians(std::min(89.0, maxLat + latPad));
+    // Great circles bow poleward; an east-west leg across the whole box
+    // reaches tan(lat) / cos(half width)
+    const double limit = qDegreesToRadians(89.0);
+    if (northmost > 0.0) northmost = std::min(limit, std::atan(std::tan(northmost) / std::cos(halfWidth)));
+    if (southmost < 0.0) southmost = std::max(-limit, std::atan(std::tan(southmost) / std::cos(halfWidth)));
+
+    // Equirectangular: east-west scale is parallel / cos(lat), north-south is 1
+    const double cosHigh = std::cos(std::max(std::abs(southmost), std::abs(northmost)));
+    const double cosLow = southmost <= 0.0 && northmost >= 0.0
+                              ? 1.0 : std::cos(std::min(std::abs(southmost), std::abs(northmost)));
+    const double equirectangular = (cosLow - cosHigh) / (cosLow + cosHigh);
+
+    // Transverse Mercator: scale 1 / sqrt(1 - B^2), B = cos(lat) sin(dLon),
+    // largest at the box corner nearest the equator
+    const double b = cosLow * std::sin(halfWidth);
+    const double maxScale = 1.0 / std::sqrt(1.0 - b * b);
+    const double transverse = (maxScale - 1.0) / (maxScale + 1.0);
+
+    if (transverse < equirectangular) {
+        projection = TransverseMercator;
+        scale = Geodesy::EarthRadius * 1000.0 * 2.0 / (1.0 + maxScale);
+        maxDistortion = transverse;
+    } else {
+        projection = Equirectangular;
+        scale = Geodesy::EarthRadius * 1000.0;
+        parallel = 2.0 * cosLow * cosHigh / (cosLow + cosHigh);
+        maxDistortion = equirectangular;
+    }
+
+    x.resize(count);
+    y.resize(count);
+    double extent = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        double east, north;
+        project(latitudes[i], longitudes[i], east, north);
+        x[i] = float(east);
+        y[i] = float(north);
+        extent = std::max(extent, std::max(std::abs(east), std::abs(north)));
+    }
+    // Each stored coordinate is off by at most half a float ulp
+    rounding = extent * std::ldexp(1.0, -22);
+}
+
+void TrackProjection::project(double latitude, double longitude, double &east, double &north) const {
+    const double lat = qDegreesToRadians(latitude);
+    const double dLon = qDegreesToRadians(longitude) - originLon;
+    if (projection == TransverseMercator) {
+        const double cosLat = std::cos(lat);
+        east = scale * std::atanh(cosLat * std::sin(dLon));
+        north = scale * (std::atan2(std::sin(lat), cosLat * std::cos(dLon)) - originLat);
+    } else {
+        east = scale * parallel * dLon;
+        north = scale * (lat - originLat);
+    }
+}
+
+void TrackProjection::unproject(double east, double north, double &latitude, double &longitude) const {
+    if (projection == TransverseMercator) {
+        const double d = north / scale + originLat;
+        const double e = east / scale;
+        latitude = qRadiansToDegrees(std::asin(std::sin(d) / std::cosh(e)));
+        longitude = qRadiansToDegrees(originLon + std::atan2(std::sinh(e), std::cos(d)));
+    } else {
+        latitude = qRadiansToDegrees(north / scale + originLat);
+        longitude = qRadiansToDegrees(east / (scale * parallel) + originLon);
+    }
+}
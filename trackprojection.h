@@ -0,0 +1,59 @@
+#ifndef TRACKPROJECTION_H
+#define TRACKPROJECTION_H
+
+#include <QSpan>
+#include <cmath>
+#include <vector>
+
+// Flat x/y metres for a whole flight, so inner loops can use Euclidean
+// arithmetic instead of spherical trigonometry.
+//
+// Two projections are considered and the one with the smaller worst-case
+// scale error over the flight's bounding box is kept: equirectangular (exact
+// north-south, degrades with latitude span) and spherical transverse
+// Mercator around the central meridian (conformal, degrades with east-west
+// span, the better choice for most cross-country flights). Scale factors
+// are balanced so every local scale lies in [1 - distortion, 1 + distortion];
+// a projected distance between two fixes is within that relative error of
+// the great-circle distance, plus resolution() for the float storage.
+// Exact scores still come from Geodesy.
+class TrackProjection {
+public:
+    enum Kind { Equirectangular, TransverseMercator };
+
+    TrackProjection() = default;
+    TrackProjection(QSpan<const double> latitudes, QSpan<const double> longitudes);
+
+    bool isEmpty() const { return x.empty(); }
+    int size() const { return int(x.size()); }
+    Kind kind() const { return projection; }
+    double distortion() const { return maxDistortion; }
+    double resolution() const { return rounding; } // m
+
+    QSpan<const float> xs() const { return QSpan<const float>(x.data(), qsizetype(x.size())); } // m, east
+    QSpan<const float> ys() const { return QSpan<const float>(y.data(), qsizetype(y.size())); } // m, north
+
+    double distance(int i, int j) const { // m
+        const double dx = double(x[size_t(j)]) - double(x[size_t(i)]);
+        const double dy = double(y[size_t(j)]) - double(y[size_t(i)]);
+        return std::sqrt(dx * dx + dy * dy);
+    }
+    // No fix pair is farther apart on the sphere than this (km)
+    double upperBound(int i, int j) const { return (distance(i, j) + rounding) / (1.0 - maxDistortion) * 0.001; }
+
+    void project(double latitude, double longitude, double &east, double &north) const;
+    void unproject(double east, double north, double &latitude, double &longitude) const;
+
+private:
+    Kind projection = Equirectangular;
+    double originLat = 0.0;      // radians
+    double originLon = 0.0;
+    double scale = 1.0;          // metres per radian along the reference line
+    double parallel = 1.0;       // equirectangular: cosine of the true-scale parallel
+    double maxDistortion = 0.0;
+    double rounding = 0.0;
+    std::vector<float> x;
+    std::vector<float> y;
+};
+
+#endif // TRACKPROJECTION_H
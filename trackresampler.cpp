@@ -0,0 +1,101 @@
+// Resampling of tracks onto a uniform time grid
+#include "trackresampler.h"
+#include "kernels.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const int MaxGap = 30; // s, longer gaps are bridged linearly and flagged
+
+// Weights of fixes [base, base + 4) for the point at fraction u along
+// segment k: a cubic Hermite whose slopes at k and k + 1 are the secants
+// through their neighbours, so uneven fix spacing is taken into account
+void cubicWeights(QSpan<const int> times, int k, double u, int base, double weights[4]) {
+    const int fixes = int(times.size());
+    const int before = std::max(k - 1, 0);
+    const int after = std::min(k + 2, fixes - 1);
+    const double h = times[k + 1] - times[k];
+    const double u2 = u * u;
+    const double u3 = u2 * u;
+    const double h00 = 2.0 * u3 - 3.0 * u2 + 1.0;
+    const double h10 = u3 - 2.0 * u2 + u;
+    const double h01 = 3.0 * u2 - 2.0 * u3;
+    const double h11 = u3 - u2;
+
+    // Slope terms, scaled from per second to per segment
+    const double a = h10 * h / (times[k + 1] - times[before]);
+    const double b = h11 * h / (times[after] - times[k]);
+    weights[k - base] += h00 - b;
+    weights[k + 1 - base] += h01 + a;
+    weights[before - base] -= a;
+    weights[after - base] += b;
+}
+
+}
+
+int ResampledTrack::sampleAt(double time) const {
+    if (isEmpty()) return -1;
+    const double sample = std::round((time - startTime) / interval);
+    return int(std::clamp(sample, 0.0, double(size() - 1)));
+}
+
+ResampledTrack TrackResampler::resample(const FlightTrack &track, double interval, Interpolation interpolation) {
+    ResampledTrack resampled;
+    resampled.interval = interval;
+    const QSpan<const int> times = track.times();
+    const int fixes = int(times.size());
+    if (fixes == 0 || !(interval > 0.0)) return resampled;
+
+    resampled.startTime = std::ceil(times[0] / interval) * interval;
+    const double endTime = times[fixes - 1];
+    if (resampled.startTime > endTime) return resampled;
+    const int count = int(std::floor((endTime - resampled.startTime) / interval)) + 1;
+
+    // Sample s is the weighted sum of fixes [first[s], first[s] + taps)
+    const int taps = fixes < 2 ? 1 : (interpolation == Cubic && fixes >= 4 ? 4 : 2);
+    std::vector<int> first(size_t(count), 0);
+    std::vector<double> weights(size_t(taps) * size_t(count), 0.0);
+    resampled.nearestFixes.assign(size_t(count), 0);
+    resampled.inGap.assign(size_t(count), 0);
+
+    int k = 0; // segment [k, k + 1] holding the sample
+    for (int s = 0; s < count; s++) {
+        if (taps == 1) {
+            weights[size_t(s)] = 1.0;
+            continue;
+        }
+        const double time = resampled.timeAt(s);
+        while (k + 2 < fixes && times[k + 1] <= time) k++;
+        const double h = times[k + 1] - times[k];
+        const double u = h > 0.0 ? std::clamp((time - times[k]) / h, 0.0, 1.0) : 0.0;
+        const bool gap = h >= MaxGap;
+        resampled.nearestFixes[size_t(s)] = u < 0.5 ? k : k + 1;
+        resampled.inGap[size_t(s)] = gap;
+
+        const int base = taps == 4 ? std::clamp(k - 1, 0, fixes - 4) : k;
+        double w[4] = {};
+        if (taps == 4 && h > 0.0 && !gap) {
+            cubicWeights(times, k, u, base, w);
+        } else {
+            w[k - base] = 1.0 - u;
+            w[k + 1 - base] = u;
+        }
+        first[size_t(s)] = base;
+        for (int tap = 0; tap < taps; tap++) weights[size_t(tap) * size_t(count) + size_t(s)] = w[tap];
+    }
+
+    // One kernel call per column, all sharing the weights
+    const Kernels::Table &kernels = Kernels::active();
+    auto interpolate = [&](const double *values, std::vector<double> &out) {
+        out.resize(size_t(count));
+        kernels.interpolate(values, first.data(), weights.data(), taps, out.data(), count);
+    };
+    interpolate(track.latitudes().data(), resampled.latitudes);
+    interpolate(track.longitudes().data(), resampled.longitudes);
+    const std::vector<double> gpsAltitudes(track.gpsAltitudes().begin(), track.gpsAltitudes().end());
+    interpolate(gpsAltitudes.data(), resampled.gpsAltitudes);
+    const std::vector<double> pressureAltitudes(track.pressureAltitudes().begin(), track.pressureAltitudes().end());
+    interpolate(pressureAltitudes.data(), resampled.pressureAltitudes);
+    return resampled;
+}
@@ -0,0 +1,41 @@
+#ifndef TRACKRESAMPLER_H
+#define TRACKRESAMPLER_H
+
+#include "flighttrack.h"
+#include <vector>
+
+// Uniform-rate view of a track, whatever rate the logger recorded at.
+// Samples sit on whole multiples of the interval since the flight epoch, so
+// two flights resampled at the same interval line up sample for sample.
+struct ResampledTrack {
+    double startTime = 0.0;                 // s since the flight epoch, sample 0
+    double interval = 1.0;                  // s between samples
+    std::vector<double> latitudes;
+    std::vector<double> longitudes;
+    std::vector<double> gpsAltitudes;       // m
+    std::vector<double> pressureAltitudes;  // m
+    std::vector<int> nearestFixes;          // track fix closest in time to each sample
+    std::vector<char> inGap;                // logger gap of 30 s or more, bridged by a straight line
+
+    bool isEmpty() const { return latitudes.empty(); }
+    int size() const { return int(latitudes.size()); }
+    double timeAt(int sample) const { return startTime + sample * interval; }
+    int sampleAt(double time) const; // nearest sample, clamped to the track
+};
+
+namespace TrackResampler {
+
+enum Interpolation {
+    Linear,
+    Cubic   // Hermite through the fixes, slopes from the neighbouring fixes
+};
+
+// Samples every interval seconds between the first and last fix. The
+// interpolation weights are worked out once per sample, then every column
+// is produced by the same gather-and-sum kernel. Cubic needs four fixes and
+// is never used across a gap.
+ResampledTrack resample(const FlightTrack &track, double interval = 1.0, Interpolation interpolation = Linear);
+
+}
+
+#endif // TRACKRESAMPLER_H
@@ -0,0 +1,85 @@
+// Track simplification for the optimizers
+#include "tracksimplifier.h"
+#include "geodesy.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+// Distance (m) from fix p to the segment a-b, in an equirectangular frame
+// anchored at a. Segments are at most a glide long, where the frame's
+// distortion is far below GPS noise.
+double segmentDistance(QSpan<const double> latitudes, QSpan<const double> longitudes, int a, int b, int p) {
+    const double scale = qDegreesToRadians(1.0) * Geodesy::EarthRadius * 1000.0;
+    const double cosLat = std::cos(qDegreesToRadians(latitudes[a]));
+    const double bx = (longitudes[b] - longitudes[a]) * cosLat * scale;
+    const double by = (latitudes[b] - latitudes[a]) * scale;
+    const double px = (longitudes[p] - longitudes[a]) * cosLat * scale;
+    const double py = (latitudes[p] - latitudes[a]) * scale;
+
+    const double length2 = bx * bx + by * by;
+    double t = length2 > 0.0 ? (px * bx + py * by) / length2 : 0.0;
+    t = std::clamp(t, 0.0, 1.0);
+    return std::hypot(px - t * bx, py - t * by);
+}
+
+}
+
+namespace TrackSimplifier {
+
+std::vector<int> simplify(QSpan<const double> latitudes, QSpan<const double> longitudes,
+                          double toleranceMetres, double &maxError) {
+    const int count = int(std::min(latitudes.size(), longitudes.size()));
+    maxError = 0.0;
+    std::vector<int> kept;
+    if (count == 0) return kept;
+    if (toleranceMetres <= 0.0 || count < 3) {
+        kept.resize(size_t(count));
+        for (int i = 0; i < count; i++) kept[size_t(i)] = i;
+        return kept;
+    }
+
+    // Iterative Douglas-Peucker; a segment is split at its worst fix until
+    // every fix is within tolerance
+    std::vector<char> keep(size_t(count), 0);
+    keep[0] = keep[size_t(count - 1)] = 1;
+    std::vector<std::pair<int, int>> segments{{0, count - 1}};
+    while (!segments.empty()) {
+        const auto [first, last] = segments.back();
+        segments.pop_back();
+
+        int worst = -1;
+        double worstDistance = 0.0;
+        for (int i = first + 1; i < last; i++) {
+            const double distance = segmentDistance(latitudes, longitudes, first, last, i);
+            if (distance > worstDistance) {
+                worstDistance = distance;
+                worst = i;
+            }
+        }
+
+        if (worst < 0 || worstDistance <= toleranceMetres) {
+            maxError = std::max(maxError, worstDistance);
+            continue;
+        }
+        keep[size_t(worst)] = 1;
+        segments.emplace_back(first, worst);
+        segments.emplace_back(worst, last);
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (keep[size_t(i)]) kept.push_back(i);
+    }
+    return kept;
+}
+
+TrackReduction reduce(QSpan<const double> latitudes, QSpan<const double> longitudes, double toleranceMetres) {
+    TrackReduction reduction;
+    reduction.tolerance = toleranceMetres;
+    reduction.indices = simplify(latitudes, longitudes, toleranceMetres, reduction.maxError);
+    return reduction;
+}
+
+}
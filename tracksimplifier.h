@@ -0,0 +1,31 @@
+#ifndef TRACKSIMPLIFIER_H
+#define TRACKSIMPLIFIER_H
+
+#include <QSpan>
+#include <vector>
+
+// Reduced view of a track for the optimizers: the fixes kept by
+// simplification, as track indices
+struct TrackReduction {
+    std::vector<int> indices;   // kept fixes, ascending, always with the first and last
+    double tolerance = 0.0;     // m, requested
+    double maxError = 0.0;      // m, farthest any dropped fix lies from the simplified track
+
+    bool isEmpty() const { return indices.empty(); }
+};
+
+namespace TrackSimplifier {
+
+// Douglas-Peucker simplification: every dropped fix lies within
+// toleranceMetres of the segment joining the kept fixes around it. The
+// largest such distance is returned in maxError (m). A tolerance of zero or
+// less keeps every fix.
+std::vector<int> simplify(QSpan<const double> latitudes, QSpan<const double> longitudes,
+                          double toleranceMetres, double &maxError);
+
+// Simplify and wrap the kept indices with the tolerance and error
+TrackReduction reduce(QSpan<const double> latitudes, QSpan<const double> longitudes, double toleranceMetres);
+
+}
+
+#endif // TRACKSIMPLIFIER_H
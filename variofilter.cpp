@@ -0,0 +1,219 @@
+// Vario filters over irregularly timed fixes
+#include "variofilter.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+const int MaxGap = 30; // s, longer gaps are not differenced
+
+// Fix-to-fix climb rates, the step into each fix. A step counts when it
+// spans 1-29 s at a believable rate; a glitch is a believable span at an
+// unbelievable rate, which marks the fix it lands on as bad.
+struct Steps {
+    std::vector<double> rate;   // m/s
+    std::vector<char> valid;
+    std::vector<char> glitch;
+};
+
+Steps measureSteps(QSpan<const int> times, QSpan<const int> altitudes, double maxClimb, double maxSink) {
+    const size_t count = size_t(times.size());
+    Steps steps;
+    steps.rate.assign(count, 0.0);
+    steps.valid.assign(count, 0);
+    steps.glitch.assign(count, 0);
+
+    // Branch-free so the compiler can vectorize it
+    for (size_t i = 1; i < count; i++) {
+        const int timeDiff = times[i] - times[i-1];
+        const double rate = double(altitudes[i] - altitudes[i-1]) / std::max(timeDiff, 1);
+        const bool span = timeDiff > 0 && timeDiff < MaxGap;
+        const bool believable = rate <= maxClimb && rate >= -maxSink;
+        steps.rate[i] = rate;
+        steps.valid[i] = span && believable;
+        steps.glitch[i] = span && !believable;
+    }
+    return steps;
+}
+
+// Fixes [lo, hi] within halfWidth seconds of fix i, advanced monotonically
+struct Window {
+    qsizetype lo = 0;
+    qsizetype hi = 0;
+
+    void advance(QSpan<const int> times, qsizetype i, double halfWidth) {
+        while (times[lo] < times[i] - halfWidth) lo++;
+        hi = std::max(hi, i);
+        while (hi + 1 < times.size() && times[hi + 1] <= times[i] + halfWidth) hi++;
+    }
+};
+
+void boxcar(QSpan<const int> times, const Steps &steps, double halfWidth, QSpan<double> out) {
+    // Prefix sums of the valid rates and of their count; each window is two lookups
+    const size_t count = size_t(times.size());
+    std::vector<double> sums(count + 1, 0.0);
+    std::vector<int> counts(count + 1, 0);
+    for (size_t i = 0; i < count; i++) {
+        sums[i + 1] = sums[i] + (steps.valid[i] ? steps.rate[i] : 0.0);
+        counts[i + 1] = counts[i] + steps.valid[i];
+    }
+
+    Window window;
+    for (qsizetype i = 0; i < times.size(); i++) {
+        window.advance(times, i, halfWidth);
+        const int inside = counts[size_t(window.hi) + 1] - counts[size_t(window.lo)];
+        out[i] = inside > 0 ? (sums[size_t(window.hi) + 1] - sums[size_t(window.lo)]) / inside : 0.0;
+    }
+}
+
+// Power sums of (t - anchor) and altitude-weighted ones over the window
+struct Moments {
+    double s[5] = {};   // sum of u^k
+    double y[3] = {};   // sum of u^k * v
+
+    void add(double u, double v, double weight) {
+        double power = weight;
+        for (int k = 0; k < 5; k++) {
+            s[k] += power;
+            if (k < 3) y[k] += power * v;
+            power *= u;
+        }
+    }
+
+    // Slope at u of the least-squares quadratic; a line when the window
+    // holds fewer than three distinct times
+    double slope(double u) const {
+        const double det = s[0] * (s[2] * s[4] - s[3] * s[3]) - s[1] * (s[1] * s[4] - s[3] * s[2]) +
+                           s[2] * (s[1] * s[3] - s[2] * s[2]);
+        if (s[0] >= 2.5 && det > 1e-12 * s[0] * s[2] * s[4]) {
+            const double c1 = (s[0] * (y[1] * s[4] - s[3] * y[2]) - y[0] * (s[1] * s[4] - s[3] * s[2]) +
+                               s[2] * (s[1] * y[2] - y[1] * s[2])) / det;
+            const double c2 = (s[0] * (s[2] * y[2] - y[1] * s[3]) - s[1] * (s[1] * y[2] - y[1] * s[2]) +
+                               y[0] * (s[1] * s[3] - s[2] * s[2])) / det;
+            return c1 + 2.0 * c2 * u;
+        }
+        const double spread = s[0] * s[2] - s[1] * s[1];
+        return spread > 1e-9 * s[0] * s[2] ? (s[0] * y[1] - s[1] * y[0]) / spread : 0.0;
+    }
+};
+
+void savitzkyGolay(QSpan<const int> times, QSpan<const int> altitudes, const Steps &steps, double halfWidth,
+                   QSpan<double> out) {
+    // Moments are kept about an anchor fix near the window, so the powers
+    // stay small; they are rebuilt about a new anchor once the window has
+    // moved on by its own length, which keeps the cost O(1) per fix
+    Moments moments;
+    Window window;
+    qsizetype anchor = -1;
+    qsizetype first = 0;    // fixes [first, last) are in the moments
+    qsizetype last = 0;
+    auto include = [&](qsizetype j, double weight) {
+        if (steps.glitch[size_t(j)]) return;
+        moments.add(times[j] - times[anchor], altitudes[j] - altitudes[anchor], weight);
+    };
+
+    for (qsizetype i = 0; i < times.size(); i++) {
+        window.advance(times, i, halfWidth);
+        if (anchor < 0 || i - anchor > std::max<qsizetype>(4, window.hi - window.lo + 1)) {
+            anchor = i;
+            moments = Moments();
+            for (qsizetype j = window.lo; j <= window.hi; j++) include(j, 1.0);
+            first = window.lo;
+            last = window.hi + 1;
+        } else {
+            for (; last <= window.hi; last++) include(last, 1.0);
+            for (; first < window.lo; first++) include(first, -1.0);
+        }
+        out[i] = moments.slope(times[i] - times[anchor]);
+    }
+}
+
+void kalman(QSpan<const int> times, QSpan<const int> altitudes, const Steps &steps, double altitudeNoise,
+            double climbNoise, QSpan<double> out) {
+    // State: altitude and climb rate, with covariance hh, hv, vv
+    struct State {
+        double h, v;
+        double hh, hv, vv;
+    };
+    const size_t count = size_t(times.size());
+    const double r = altitudeNoise * altitudeNoise;
+    const double q = climbNoise * climbNoise;
+    std::vector<State> predicted(count);
+    std::vector<State> filtered(count);
+
+    State x = {double(altitudes[0]), 0.0, r, 0.0, 100.0}; // climb unknown, about +-10 m/s
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) {
+            // Constant climb between fixes, driven by white noise in the climb rate
+            const double dt = std::max(0, times[i] - times[i-1]);
+            x.h += x.v * dt;
+            x.hh += 2.0 * dt * x.hv + dt * dt * x.vv + q * dt * dt * dt / 3.0;
+            x.hv += dt * x.vv + q * dt * dt / 2.0;
+            x.vv += q * dt;
+        }
+        predicted[i] = x;
+
+        if (i == 0 || !steps.glitch[i]) {
+            const double s = x.hh + r;
+            const double kh = x.hh / s;
+            const double kv = x.hv / s;
+            const double innovation = altitudes[i] - x.h;
+            x.h += kh * innovation;
+            x.v += kv * innovation;
+            x.vv -= kv * x.hv;
+            x.hv -= kh * x.hv;
+            x.hh -= kh * x.hh;
+        }
+        filtered[i] = x;
+    }
+
+    // Rauch-Tung-Striebel pass: fold the later fixes back in
+    double h = filtered[count - 1].h;
+    double v = filtered[count - 1].v;
+    out[qsizetype(count) - 1] = v;
+    for (size_t i = count - 1; i-- > 0;) {
+        const State &f = filtered[i];
+        const State &p = predicted[i + 1];
+        const double dt = std::max(0, times[qsizetype(i) + 1] - times[qsizetype(i)]);
+        const double det = p.hh * p.vv - p.hv * p.hv;
+        // Gain = P_filtered * F^T * P_predicted^-1
+        const double a = f.hh + dt * f.hv, b = f.hv;
+        const double c = f.hv + dt * f.vv, d = f.vv;
+        const double dh = h - p.h;
+        const double dv = v - p.v;
+        const double gh = (p.vv * dh - p.hv * dv) / det;
+        const double gv = (p.hh * dv - p.hv * dh) / det;
+        h = f.h + a * gh + b * gv;
+        v = f.v + c * gh + d * gv;
+        out[qsizetype(i)] = v;
+    }
+}
+
+}
+
+bool VarioFilter::operator==(const VarioFilter &other) const {
+    return kind == other.kind && window == other.window && altitudeNoise == other.altitudeNoise &&
+           climbNoise == other.climbNoise && maxClimb == other.maxClimb && maxSink == other.maxSink;
+}
+
+void VarioFilter::apply(QSpan<const int> times, QSpan<const int> altitudes, QSpan<double> out) const {
+    const qsizetype count = std::min({times.size(), altitudes.size(), out.size()});
+    if (count == 0) return;
+    times = times.first(count);
+    altitudes = altitudes.first(count);
+    out = out.first(count);
+
+    const Steps steps = measureSteps(times, altitudes, maxClimb, maxSink);
+    switch (kind) {
+    case Boxcar:
+        boxcar(times, steps, window * 0.5, out);
+        break;
+    case SavitzkyGolay:
+        savitzkyGolay(times, altitudes, steps, window * 0.5, out);
+        break;
+    case Kalman:
+        kalman(times, altitudes, steps, altitudeNoise, climbNoise, out);
+        break;
+    }
+}
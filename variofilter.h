@@ -0,0 +1,36 @@
+#ifndef VARIOFILTER_H
+#define VARIOFILTER_H
+
+#include <QSpan>
+
+// Vertical speed from the GPS altitude column.
+//
+// Windows are in seconds, so the same setting means the same thing on 1, 2
+// and 5 Hz loggers, and each filter costs O(1) per fix however wide it is:
+// the boxcar reads prefix sums, Savitzky-Golay keeps running moments of the
+// window (re-anchored as it moves, so they never lose precision), and the
+// Kalman smoother is one forward and one backward sweep. Steps faster than
+// maxClimb or maxSink are logger glitches and are left out, not clamped;
+// fixes more than 30 s apart are never differenced.
+struct VarioFilter {
+    enum Kind {
+        Boxcar,         // mean of the fix-to-fix rates inside the window
+        SavitzkyGolay,  // slope of the least-squares quadratic through the window's altitudes
+        Kalman          // constant-climb model, smoothed forwards and backwards
+    };
+
+    Kind kind = Boxcar;
+    double window = 3.0;            // s, full width (Boxcar, SavitzkyGolay)
+    double altitudeNoise = 3.0;     // m, GPS altitude error (Kalman)
+    double climbNoise = 1.0;        // m/s per sqrt(s), how fast the climb rate wanders (Kalman)
+    double maxClimb = 25.0;         // m/s
+    double maxSink = 35.0;          // m/s
+
+    bool operator==(const VarioFilter &other) const;
+    bool operator!=(const VarioFilter &other) const { return !(*this == other); }
+
+    // out[i] = vertical speed at fix i (m/s); times in seconds, non-decreasing
+    void apply(QSpan<const int> times, QSpan<const int> altitudes, QSpan<double> out) const;
+};
+
+#endif // VARIOFILTER_H
@@ -0,0 +1,123 @@
+// Streaming wind estimation from circling flight
+#include "windestimator.h"
+#include "circlingindex.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const int Window = 45;          // s of legs kept; a turn takes at most this long
+const int MinLegs = 8;          // per fitted turn
+const double MinAirspeed = 4.0; // m/s; slower fits are not flight
+const double MaxAirspeed = 70.0;
+
+}
+
+double WindSample::speed() const {
+    return std::hypot(east, north);
+}
+
+double WindSample::direction() const {
+    const double degrees = qRadiansToDegrees(std::atan2(-east, -north));
+    return degrees < 0.0 ? degrees + 360.0 : degrees;
+}
+
+void WindEstimator::gap() {
+    window.clear();
+    fit.clear();
+    turned = 0.0;
+    haveCourse = false;
+}
+
+void WindEstimator::add(int time, int altitude, double groundSpeed, double course) {
+    if (groundSpeed <= MinCourseSpeed) {
+        gap();
+        return;
+    }
+
+    Leg leg;
+    leg.time = time;
+    leg.east = groundSpeed * std::sin(qDegreesToRadians(course));
+    leg.north = groundSpeed * std::cos(qDegreesToRadians(course));
+    leg.turn = 0.0;
+    if (haveCourse) {
+        leg.turn = course - lastCourse;
+        leg.turn -= 360.0 * std::floor(leg.turn / 360.0 + 0.5);
+    }
+    lastCourse = course;
+    haveCourse = true;
+
+    window.push_back(leg);
+    fit.add(leg.east, leg.north);
+    turned += leg.turn;
+    while (time - window.front().time >= Window) {
+        const Leg &old = window.front();
+        fit.remove(old.east, old.north);
+        window.pop_front();
+        turned -= window.front().turn; // that turn led from the leg just dropped
+    }
+
+    if (std::abs(turned) < 360.0 || fit.size() < MinLegs) return;
+    double east, north, airspeed;
+    if (!fit.solve(CircleFit::Kasa, east, north, airspeed)) return;
+    if (airspeed < MinAirspeed || airspeed > MaxAirspeed) return;
+
+    // A full turn puts the centre's standard error at rms * sqrt(2 / n)
+    WindSample sample;
+    sample.time = time;
+    sample.altitude = altitude;
+    sample.east = east;
+    sample.north = north;
+    sample.airspeed = airspeed;
+    sample.error = std::sqrt(fit.meanSquareError(east, north, airspeed) * 2.0 / fit.size());
+    series.push_back(sample);
+
+    // Start the next turn from fresh legs, so no two samples share data and
+    // their errors stay independent for the weighted means
+    window.clear();
+    fit.clear();
+    turned = 0.0;
+}
+
+WindSample WindEstimator::mean(const std::vector<WindSample> &samples, int low, int high) {
+    WindSample result;
+    double weightSum = 0.0;
+    double timeSum = 0.0;
+    double altitudeSum = 0.0;
+    for (const WindSample &sample : samples) {
+        if (sample.altitude < low || sample.altitude >= high) continue;
+        const double weight = 1.0 / std::max(sample.error * sample.error, 0.01); // 0.1 m/s floor
+        result.east += weight * sample.east;
+        result.north += weight * sample.north;
+        result.airspeed += weight * sample.airspeed;
+        timeSum += weight * sample.time;
+        altitudeSum += weight * sample.altitude;
+        weightSum += weight;
+    }
+    if (weightSum == 0.0) return result;
+    result.east /= weightSum;
+    result.north /= weightSum;
+    result.airspeed /= weightSum;
+    result.time = int(timeSum / weightSum);
+    result.altitude = int(altitudeSum / weightSum);
+    result.error = std::sqrt(1.0 / weightSum);
+    return result;
+}
+
+std::vector<WindSample> WindEstimator::byAltitude(const std::vector<WindSample> &samples, int bandHeight) {
+    std::vector<WindSample> bands;
+    if (samples.empty() || bandHeight <= 0) return bands;
+
+    auto [lowest, highest] = std::minmax_element(samples.begin(), samples.end(),
+                                                 [](const WindSample &a, const WindSample &b) {
+                                                     return a.altitude < b.altitude;
+                                                 });
+    const int first = int(std::floor(double(lowest->altitude) / bandHeight));
+    const int last = int(std::floor(double(highest->altitude) / bandHeight));
+    for (int band = first; band <= last; band++) {
+        const WindSample wind = mean(samples, band * bandHeight, (band + 1) * bandHeight);
+        if (wind.error > 0.0) bands.push_back(wind);
+    }
+    return bands;
+}
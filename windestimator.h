@@ -0,0 +1,59 @@
+#ifndef WINDESTIMATOR_H
+#define WINDESTIMATOR_H
+
+#include "circlefit.h"
+#include <deque>
+#include <vector>
+
+struct WindSample {
+    int time = 0;               // s since the flight epoch
+    int altitude = 0;           // m, GPS
+    double east = 0.0;          // m/s, the way the air moves
+    double north = 0.0;
+    double airspeed = 0.0;      // m/s
+    double error = 0.0;         // m/s, one-sigma uncertainty of east and north
+
+    double speed() const;       // m/s
+    double direction() const;   // degrees the wind blows from
+};
+
+// Wind from the ground speed variation while circling.
+//
+// In steady turns at constant airspeed the ground velocity vectors lie on
+// a circle whose centre is the wind and whose radius is the airspeed. The
+// estimator keeps a circle fit over a sliding window of recent velocities
+// and reads a sample once the window holds a full turn, then starts the
+// window over: one sample per turn, none sharing legs. Each fix costs O(1),
+// so it can run inside the pass that derives the speeds.
+class WindEstimator {
+public:
+    // One flown leg ending at time; speed in m/s, course in degrees
+    void add(int time, int altitude, double groundSpeed, double course);
+    void gap(); // the next leg does not follow on from the last
+
+    const std::vector<WindSample>& samples() const { return series; }
+
+    // Inverse-variance mean of the samples between the altitudes [low, high);
+    // the samples are independent, so the error shrinks with their count
+    static WindSample mean(const std::vector<WindSample> &samples, int low, int high);
+
+    // Mean wind per altitude band of bandHeight metres, lowest first; bands
+    // without samples are left out
+    static std::vector<WindSample> byAltitude(const std::vector<WindSample> &samples, int bandHeight = 500);
+
+private:
+    struct Leg {
+        int time;
+        double east, north;     // m/s, ground velocity
+        double turn;            // degrees since the previous leg
+    };
+
+    std::deque<Leg> window;
+    CircleFit fit;
+    double turned = 0.0;        // degrees across the window, signed
+    double lastCourse = 0.0;
+    bool haveCourse = false;
+    std::vector<WindSample> series;
+};
+
+#endif // WINDESTIMATOR_H